@@ -13,6 +13,10 @@ if (WIN32 AND Freetype_FOUND)
 	list(APPEND AVAILABLE_BACKENDS "gdi")
 endif ()
 
+if (Freetype_FOUND)
+	list(APPEND AVAILABLE_BACKENDS "offscreen")
+endif ()
+
 list(APPEND AVAILABLE_BACKENDS "none")
 
 string(REGEX MATCH "^[^;][^;]*" FIRST_BACKEND "${AVAILABLE_BACKENDS}")
@@ -6,6 +6,7 @@ target_sources(simutrans PRIVATE
 		src/simutrans/builder/tree_builder.cc
 		src/simutrans/builder/tunnelbauer.cc
 		src/simutrans/builder/vehikelbauer.cc
+		src/simutrans/builder/way_pathfinder.cc
 		src/simutrans/builder/wegbauer.cc
 		src/simutrans/dataobj/crossing_logic.cc
 		src/simutrans/dataobj/environment.cc
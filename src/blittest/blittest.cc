@@ -0,0 +1,164 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+/*
+ * Self test and benchmark of the blend and alpha procedures of simgraph16
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "../simutrans/display/simgraph16_blit.h"
+
+
+typedef void (*blend_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL colour, const PIXVAL len);
+
+static blend_proc blend[3] = {
+	pix_blend_tpl<blend25_t>,
+	pix_blend_tpl<blend50_t>,
+	pix_blend_tpl<blend75_t> };
+
+static blend_proc outline[3] = {
+	pix_outline_tpl<blend25_t>,
+	pix_outline_tpl<blend50_t>,
+	pix_outline_tpl<blend75_t> };
+
+static const char *blend_names[3] = { "25%", "50%", "75%" };
+
+// stands in for the colour table of the renderer
+static PIXVAL rgbmap[0x10000];
+
+static uint32 seed = 0x2545F491;
+
+static uint32 next_random()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+
+/// alpha procedure @p p: 0 = alpha, 1 = alpha with recoding
+static void run_alpha(int p, PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, PIXVAL alpha_mask, PIXVAL len)
+{
+	if(  p == 0  ) {
+		alpha( dest, src, alphamap, alpha_mask, 0, len );
+	}
+	else {
+		alpha_recode_map( dest, src, alphamap, alpha_mask, len, rgbmap );
+	}
+}
+
+
+/**
+ * Called with a length of one, the procedures only run their scalar code,
+ * which gives the reference pixels for runs of any length and alignment.
+ * @returns false if any pixel differs
+ */
+static bool compare_runs(uint32 rounds)
+{
+	PIXVAL src[96], alphamap[96], dest[96], expected[96];
+	for(  uint32 r = 0;  r < rounds;  r++  ) {
+		// every length up to a few vectors, at any alignment
+		const int len   = next_random() % 67;
+		const int start = next_random() % 16;
+		for(  int i = 0;  i < start + len;  i++  ) {
+			src[i]      = (PIXVAL)next_random();
+			alphamap[i] = (PIXVAL)next_random() & 0x7FFF;
+			dest[i]     = (PIXVAL)next_random();
+		}
+		const PIXVAL colour = (PIXVAL)next_random();
+		// any combination of the red, green and blue alpha channels
+		const uint32 channels = 1 + next_random() % 7;
+		const PIXVAL alpha_mask = (channels & 1 ? 0x7c00 : 0) | (channels & 2 ? 0x03e0 : 0) | (channels & 4 ? 0x001f : 0);
+
+		for(  int p = 0;  p < 6;  p++  ) {
+			blend_proc proc = p < 3 ? blend[p] : outline[p - 3];
+			memcpy( expected, dest, (start + len) * sizeof(PIXVAL) );
+			for(  int i = start;  i < start + len;  i++  ) {
+				proc( expected + i, src + i, colour, 1 );
+			}
+			proc( dest + start, src + start, colour, len );
+			if(  memcmp( expected, dest, (start + len) * sizeof(PIXVAL) )  ) {
+				printf( "%s %s differs, length %d\n", p < 3 ? "blend" : "outline", blend_names[p % 3], len );
+				return false;
+			}
+		}
+
+		for(  int p = 0;  p < 2;  p++  ) {
+			memcpy( expected, dest, (start + len) * sizeof(PIXVAL) );
+			for(  int i = start;  i < start + len;  i++  ) {
+				run_alpha( p, expected + i, src + i, alphamap + i, alpha_mask, 1 );
+			}
+			run_alpha( p, dest + start, src + start, alphamap + start, alpha_mask, len );
+			if(  memcmp( expected, dest, (start + len) * sizeof(PIXVAL) )  ) {
+				printf( "%s differs, length %d, mask %04x\n", p == 0 ? "alpha" : "alpha_recode", len, alpha_mask );
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+/// times each procedure on the same full HD line again and again
+static void time_lines(uint32 rounds)
+{
+	const int LINE_LEN = 1920;
+	std::vector<PIXVAL> src(LINE_LEN), alphamap(LINE_LEN), dest(LINE_LEN);
+	for(  int i = 0;  i < LINE_LEN;  i++  ) {
+		src[i]      = (PIXVAL)next_random();
+		alphamap[i] = (PIXVAL)next_random() & 0x7FFF;
+		dest[i]     = (PIXVAL)next_random();
+	}
+
+	for(  int p = 0;  p < 8;  p++  ) {
+		const auto start_time = std::chrono::steady_clock::now();
+		for(  uint32 r = 0;  r < rounds;  r++  ) {
+			if(  p < 6  ) {
+				(p < 3 ? blend[p] : outline[p - 3])( dest.data(), src.data(), src[r % LINE_LEN], LINE_LEN );
+			}
+			else {
+				run_alpha( p - 6, dest.data(), src.data(), alphamap.data(), 0x7FFF, LINE_LEN );
+			}
+		}
+		const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start_time ).count();
+		const char *name = p < 3 ? "blend" : p < 6 ? "outline" : p == 6 ? "alpha" : "alpha_recode";
+		printf( "%-12s %s %u lines of %d pixels: %lld ms\n", name, p < 6 ? blend_names[p % 3] : "   ", rounds, LINE_LEN, ms );
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	const uint32 rounds = argc > 1 ? (uint32)atoi(argv[1]) : 100000;
+	if(  rounds == 0  ) {
+		fprintf( stderr, "Usage: blittest [rounds]\n" );
+		return EXIT_FAILURE;
+	}
+
+	for(  uint32 i = 0;  i < 0x10000;  i++  ) {
+		rgbmap[i] = (PIXVAL)next_random();
+	}
+
+#ifdef SIMD_PIXELS
+	printf( "Vectors of %d pixels\n", SIMD_PIXELS );
+#else
+	printf( "No vector code on this target\n" );
+#endif
+
+	if(  !compare_runs( rounds )  ) {
+		printf( "FAILED\n" );
+		return EXIT_FAILURE;
+	}
+	printf( "All pixels identical\n" );
+
+	time_lines( rounds );
+	return EXIT_SUCCESS;
+}
@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <chrono>
 
 // Needed for interaction with console
 // <windows.h> also needed, but this is included by networking code
@@ -29,6 +30,11 @@
 #include "../simutrans/utils/sha1.h"
 
 
+// address of the server, as given by -s
+static char default_server_address[] = "localhost:13353";
+static char *server_address = default_server_address;
+
+
 // dummy implementation
 // only receive nwc_service_t here
 // called from network_check_activity
@@ -335,6 +341,52 @@ int say(SOCKET socket, uint32 command_id, int argc, char **argv) {
 	return 0;
 }
 
+// Opens many idle connections, then measures how fast the server still answers
+int bench_clients(SOCKET socket, uint32 command_id, int, char **argv) {
+	const int count = atoi(argv[0]);
+	if (count<=0) {
+		return 3;
+	}
+
+	vector_tpl<SOCKET> idle(count);
+	for (int i=0; i<count; i++) {
+		const char *error = NULL;
+		SOCKET const s = network_open_address(server_address, error);
+		if (error) {
+			fprintf(stderr, "Could only open %d connections: %s\n", i, error);
+			break;
+		}
+		idle.append(s);
+	}
+
+	// the client list request makes the server walk all its connections
+	const int rounds = 100;
+	int answered = 0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i=0; i<rounds; i++) {
+		nwc_service_t nwcs;
+		nwcs.flag = command_id;
+		if (!nwcs.send(socket)) {
+			fprintf(stderr, "Could not send request!\n");
+			break;
+		}
+		nwc_service_t *nws = (nwc_service_t*)network_receive_command(NWC_SERVICE);
+		if (nws==NULL) {
+			break;
+		}
+		delete nws;
+		answered++;
+	}
+	const long ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%u idle connections: %d requests answered in %ld ms (%.2f ms per request)\n", idle.get_count(), answered, ms, answered ? (double)ms / answered : 0.0);
+
+	for(SOCKET const s : idle) {
+		network_close_socket(s);
+	}
+	return answered==rounds ? 0 : 3;
+}
+
 int lock_company(SOCKET socket, uint32, int argc, char **argv)
 {
 	// player number
@@ -454,6 +506,13 @@ void usage()
 		"      force-sync\n"
 		"        Force server to send sync command in order to save & reload the game\n"
 		"\n"
+		"      script-profile\n"
+		"        Write profiles of all scripts on the server (needs -script_profile)\n"
+		"        and show the most expensive functions\n"
+		"\n"
+		"      bench-clients <number of connections>\n"
+		"        Open this many idle connections and time 100 client list requests\n"
+		"\n"
 		"    Return codes:\n"
 		"      0 .. success\n"
 		"      1 .. server not reachable\n"
@@ -487,8 +546,6 @@ int main(int argc, char* argv[]) {
 	Fetchopt_t fetchopt(argc, argv, "hp:P:qs:");
 
 	bool opt_q = false;
-	char default_server_address[] = "localhost:13353";
-	char *server_address = default_server_address;
 	char *password = NULL;
 
 	int ch;
@@ -558,7 +615,9 @@ int main(int argc, char* argv[]) {
 		{"info-company",   true,  nwc_service_t::SRVC_GET_COMPANY_INFO, 1, &simple_gettext_command},
 		{"unlock-company", true,  nwc_service_t::SRVC_UNLOCK_COMPANY,   1, &simple_command},
 		{"remove-company", true,  nwc_service_t::SRVC_REMOVE_COMPANY,   1, &simple_command},
-		{"lock-company",   true,  nwc_service_t::SRVC_LOCK_COMPANY,     2, &lock_company}
+		{"lock-company",   true,  nwc_service_t::SRVC_LOCK_COMPANY,     2, &lock_company},
+		{"script-profile", true,  nwc_service_t::SRVC_SCRIPT_PROFILE,   0, &simple_gettext_command},
+		{"bench-clients",  true,  nwc_service_t::SRVC_GET_CLIENT_LIST,  1, &bench_clients}
 	};
 	int numcommands = lengthof(commands);
 
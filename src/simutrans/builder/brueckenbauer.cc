@@ -138,7 +138,7 @@ void bridge_builder_t::fill_menu(tool_selector_t *tool_selector, const waytype_t
 
 const vector_tpl<const bridge_desc_t *>&  bridge_builder_t::get_available_bridges(const waytype_t wtyp)
 {
-	static vector_tpl<const bridge_desc_t *> dummy;
+	static thread_local vector_tpl<const bridge_desc_t *> dummy;
 	dummy.clear();
 	const uint16 time = welt->get_timeline_year_month();
 	for(auto const& i : desc_table) {
@@ -165,6 +165,7 @@ public:
 
 	/**
 	 * Returns a list with available bridge types.
+	 * The list belongs to the calling thread and is refilled by its next call.
 	 */
 	static const vector_tpl<const bridge_desc_t *>& get_available_bridges(const waytype_t wtyp);
 };
@@ -44,6 +44,7 @@ public:
 	static void fill_menu(tool_selector_t *tool_selector, const waytype_t wtyp, sint16 sound_ok);
 	/**
 	 * Returns a list with available tunnel types.
+	 * The list belongs to the calling thread and is refilled by its next call.
 	 */
 	static const vector_tpl<const tunnel_desc_t *>& get_available_tunnels(const waytype_t wtyp);
 
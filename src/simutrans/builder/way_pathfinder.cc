@@ -0,0 +1,301 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "way_pathfinder.h"
+
+#include "../simdebug.h"
+#include "../dataobj/marker.h"
+#include "../dataobj/settings.h"
+#include "../descriptor/way_desc.h"
+#include "../ground/grund.h"
+#include "../world/simworld.h"
+
+
+karte_ptr_t way_pathfinder_t::welt;
+
+
+way_pathfinder_t::way_pathfinder_t(player_t *player) :
+	bob(player),
+	desc(NULL),
+	bridge_desc(NULL),
+	tunnel_desc(NULL),
+	state(idle),
+	closed(NULL),
+	rotation(0),
+	expanded(0),
+	route_cost(0)
+{
+	settings_t const& s = welt->get_settings();
+	costs.way      = s.way_count_straight;
+	costs.no_way   = s.way_count_no_way;
+	costs.slope    = s.way_count_slope;
+	costs.curve    = s.way_count_curve;
+	costs.crossing = s.way_count_avoid_crossings;
+	costs.bridge   = s.way_count_tunnel;
+	costs.tunnel   = s.way_count_tunnel;
+	costs.maximum  = s.way_count_maximum;
+
+	bob.set_keep_existing_faster_ways(true);
+	bob.set_keep_city_roads(true);
+}
+
+
+way_pathfinder_t::~way_pathfinder_t()
+{
+	delete closed;
+}
+
+
+void way_pathfinder_t::set_way(const way_desc_t *d)
+{
+	desc = d;
+	if(  state == searching  ) {
+		finish_search( idle, NONE );
+	}
+}
+
+
+void way_pathfinder_t::set_bridge(const bridge_desc_t *d)
+{
+	bridge_desc = d;
+	if(  state == searching  ) {
+		finish_search( idle, NONE );
+	}
+}
+
+
+void way_pathfinder_t::set_tunnel(const tunnel_desc_t *d)
+{
+	tunnel_desc = d;
+	if(  state == searching  ) {
+		finish_search( idle, NONE );
+	}
+}
+
+
+void way_pathfinder_t::add_start(koord3d pos)
+{
+	if(  state != idle  ) {
+		finish_search( idle, NONE );
+	}
+	starts.append_unique( pos );
+}
+
+
+void way_pathfinder_t::add_target(koord3d pos)
+{
+	if(  state != idle  ) {
+		finish_search( idle, NONE );
+	}
+	targets.append_unique( pos );
+}
+
+
+void way_pathfinder_t::clear()
+{
+	finish_search( idle, NONE );
+	starts.clear();
+	targets.clear();
+	route.clear();
+	route_cost = 0;
+}
+
+
+uint32 way_pathfinder_t::estimate(koord3d pos) const
+{
+	// distance to the cuboid of all targets, times the cheapest step
+	uint32 dist = 0;
+	if     ( pos.x < mini.x ) { dist += mini.x - pos.x; }
+	else if( pos.x > maxi.x ) { dist += pos.x - maxi.x; }
+	if     ( pos.y < mini.y ) { dist += mini.y - pos.y; }
+	else if( pos.y > maxi.y ) { dist += pos.y - maxi.y; }
+
+	const sint32 cheapest = min( costs.way, costs.no_way );
+	return cheapest > 0 ? dist * cheapest : 0;
+}
+
+
+void way_pathfinder_t::add_node(uint32 parent, const grund_t *to, uint32 g, ribi_t::ribi dir, uint8 flags)
+{
+	if(  g > costs.maximum  ) {
+		return;
+	}
+
+	node_t node;
+	node.pos = to->get_pos();
+	node.parent = parent;
+	node.g = g;
+	node.dir = dir;
+	node.flags = flags;
+	nodes.append( node );
+
+	open_node_t o;
+	o.f = g + estimate( node.pos );
+	o.index = nodes.get_count() - 1;
+	open.insert( o );
+}
+
+
+bool way_pathfinder_t::init_search()
+{
+	route.clear();
+	route_cost = 0;
+	expanded = 0;
+
+	if(  desc == NULL  ||  starts.empty()  ||  targets.empty()  ) {
+		state = failed;
+		return false;
+	}
+
+	bob.init_builder( (way_builder_t::bautyp_t)desc->get_waytype(), desc, tunnel_desc, bridge_desc );
+
+	mini = maxi = targets[0];
+	for(koord3d const& pos : targets) {
+		mini.x = min( mini.x, pos.x );  maxi.x = max( maxi.x, pos.x );
+		mini.y = min( mini.y, pos.y );  maxi.y = max( maxi.y, pos.y );
+	}
+
+	closed_size = welt->get_size();
+	rotation = welt->get_settings().get_rotation();
+	delete closed;
+	closed = new marker_t( closed_size.x, closed_size.y );
+
+	nodes.clear();
+	open.clear();
+	for(koord3d const& pos : starts) {
+		const grund_t *gr = welt->lookup( pos );
+		sint32 dummy;
+		if(  gr  &&  bob.is_allowed_step( gr, gr, &dummy )  ) {
+			add_node( NONE, gr, 0, ribi_t::none, 0 );
+		}
+	}
+
+	state = open.empty() ? failed : searching;
+	return state == searching;
+}
+
+
+void way_pathfinder_t::finish_search(state_t result, uint32 target_index)
+{
+	if(  result == found  ) {
+		route_cost = nodes[target_index].g;
+		for(  uint32 i = target_index;  i != NONE;  i = nodes[i].parent  ) {
+			route.insert_at( 0, nodes[i].pos );
+		}
+	}
+	state = result;
+
+	// free the search memory, only the route is needed now
+	vector_tpl<node_t> empty;
+	swap( nodes, empty );
+	open.clear();
+	delete closed;
+	closed = NULL;
+}
+
+
+void way_pathfinder_t::expand(uint32 index, const grund_t *gr)
+{
+	// copy, since nodes may grow below
+	const node_t node = nodes[index];
+	const koord3d parent_pos = node.parent != NONE ? nodes[node.parent].pos : koord3d::invalid;
+	const waytype_t wt = desc->get_wtyp();
+
+	// same rules as way_builder_t::intern_calc_route(): do not go back, follow the slope, go straight after a bridge
+	const ribi_t::ribi straight_dir = node.parent != NONE ? ribi_type( parent_pos, node.pos ) : (ribi_t::ribi)ribi_t::all;
+	const ribi_t::ribi slope_dir = (slope_t::is_way_ns( gr->get_weg_hang() ) ? ribi_t::northsouth : ribi_t::none) | (slope_t::is_way_ew( gr->get_weg_hang() ) ? ribi_t::eastwest : ribi_t::none);
+	const ribi_t::ribi test_dir = (node.flags & build_straight) == 0 ? slope_dir & ~ribi_t::backward( straight_dir ) : straight_dir;
+
+	for(  ribi_t::ribi r = 1;  (r & 16) == 0;  r <<= 1  ) {
+		if(  (r & test_dir) == 0  ) {
+			continue;
+		}
+
+		grund_t *to;
+		if(  !gr->get_neighbour( to, invalid_wt, r )  ||  !bob.check_slope( gr, to )  ||  closed->is_marked( to )  ) {
+			continue;
+		}
+
+		sint32 dummy;
+		if(  bob.is_allowed_step( gr, to, &dummy )  ) {
+			uint32 g = node.g + (to->hat_weg( wt ) ? costs.way : costs.no_way);
+			if(  to->get_weg_hang() != slope_t::flat  ) {
+				g += costs.slope;
+			}
+			if(  to->hat_wege()  &&  !to->hat_weg( wt )  ) {
+				g += costs.crossing;
+			}
+			if(  node.dir != ribi_t::none  &&  node.dir != r  ) {
+				g += costs.curve;
+			}
+			add_node( index, to, g, r, 0 );
+		}
+		else if(  node.parent != NONE  &&  r == straight_dir  &&  (node.flags & build_tunnel_bridge) == 0  &&  (bridge_desc  ||  tunnel_desc)  ) {
+			// blocked: try a bridge or tunnel starting here
+			const grund_t *parent_gr = welt->lookup( parent_pos );
+			if(  parent_gr == NULL  ) {
+				continue;
+			}
+			bob.next_gr.clear();
+			bob.check_for_bridge( parent_gr, gr, targets );
+			for(way_builder_t::next_gr_t const& n : bob.next_gr) {
+				if(  n.gr == NULL  ||  closed->is_marked( n.gr )  ) {
+					continue;
+				}
+				// uphill can only be a tunnel, everything else a bridge
+				const bool is_tunnel = gr->get_grund_hang() != slope_t::flat  &&  ribi_type( gr->get_grund_hang() ) == r;
+				const uint32 length = koord_distance( gr->get_pos(), n.gr->get_pos() );
+				add_node( index, n.gr, node.g + length * (is_tunnel ? costs.tunnel : costs.bridge), r, build_straight | build_tunnel_bridge );
+			}
+		}
+	}
+}
+
+
+way_pathfinder_t::state_t way_pathfinder_t::step(uint32 max_nodes)
+{
+	if(  state == idle  &&  !init_search()  ) {
+		return state;
+	}
+	if(  state != searching  ) {
+		return state;
+	}
+
+	if(  welt->get_size() != closed_size  ||  welt->get_settings().get_rotation() != rotation  ) {
+		// map was enlarged or rotated, the closed list and the nodes do not fit any more
+		finish_search( failed, NONE );
+		return state;
+	}
+
+	const uint32 max_route_steps = welt->get_settings().get_max_route_steps();
+	for(  uint32 n = 0;  n < max_nodes  &&  !open.empty();  ) {
+		const open_node_t o = open.pop();
+		const grund_t *gr = welt->lookup( nodes[o.index].pos );
+		if(  gr == NULL  ||  closed->test_and_mark( gr )  ) {
+			// removed meanwhile, or already reached on a cheaper route
+			continue;
+		}
+		n++;
+		expanded++;
+
+		if(  targets.is_contained( gr->get_pos() )  ) {
+			finish_search( found, o.index );
+			return state;
+		}
+
+		expand( o.index, gr );
+
+		if(  nodes.get_count() >= max_route_steps  ) {
+			dbg->warning( "way_pathfinder_t::step()", "Too many steps (%i>=max %i) in route (too long/complex)", nodes.get_count(), max_route_steps );
+			finish_search( failed, NONE );
+			return state;
+		}
+	}
+
+	if(  open.empty()  ) {
+		finish_search( failed, NONE );
+	}
+	return state;
+}
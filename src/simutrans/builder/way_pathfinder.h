@@ -0,0 +1,148 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef BUILDER_WAY_PATHFINDER_H
+#define BUILDER_WAY_PATHFINDER_H
+
+
+#include "wegbauer.h"
+#include "../simtypes.h"
+#include "../dataobj/koord3d.h"
+#include "../dataobj/ribi.h"
+#include "../tpl/binary_heap_tpl.h"
+#include "../tpl/vector_tpl.h"
+
+
+class marker_t;
+
+
+/**
+ * A* search for a new way, which can be run in small portions.
+ *
+ * Unlike way_builder_t::calc_route() the search keeps its own nodes, so it
+ * can be continued in a later step while the world goes on, and the step
+ * costs are set per search instead of taken from the settings. Whether a
+ * step is allowed at all, and where bridges and tunnels can be built, is
+ * decided by way_builder_t exactly as for the build tools.
+ *
+ * Used by scripts (way_pathfinder_x), which would otherwise need to run
+ * the whole search in the script VM.
+ */
+class way_pathfinder_t
+{
+public:
+	enum state_t {
+		idle,      ///< nothing to search yet
+		searching,
+		found,     ///< route is available
+		failed
+	};
+
+	/// costs of one step, initialised from the way_count_* settings
+	struct costs_t {
+		sint32 way;       ///< step on a tile with our way
+		sint32 no_way;    ///< step on a tile without our way
+		sint32 slope;     ///< additional cost for slopes
+		sint32 curve;     ///< additional cost for each change of direction
+		sint32 crossing;  ///< additional cost for tiles with other ways
+		sint32 bridge;    ///< per tile of a bridge
+		sint32 tunnel;    ///< per tile of a tunnel
+		uint32 maximum;   ///< routes that cost more are not searched
+	};
+
+	way_pathfinder_t(player_t *player);
+	~way_pathfinder_t();
+
+	/// way to plan, also selects the way type
+	void set_way(const way_desc_t *desc);
+
+	/// bridges to use, NULL for none
+	void set_bridge(const bridge_desc_t *desc);
+
+	/// tunnels to use, NULL for none
+	void set_tunnel(const tunnel_desc_t *desc);
+
+	costs_t &get_costs() { return costs; }
+
+	/// Adds a tile the route may start from; ends a previous search.
+	void add_start(koord3d pos);
+
+	/// Adds a tile the route may end on; ends a previous search.
+	void add_target(koord3d pos);
+
+	/// Forgets start and target tiles and the result.
+	void clear();
+
+	/**
+	 * Continues the search (and starts it if needed).
+	 * @param max_nodes at most so many tiles are expanded in this call
+	 * @returns state afterwards
+	 */
+	state_t step(uint32 max_nodes);
+
+	state_t get_state() const { return state; }
+
+	/// number of tiles expanded so far
+	uint32 get_expanded_count() const { return expanded; }
+
+	/// @returns route from a start to a target tile, non-adjacent successive tiles are ends of a bridge or tunnel
+	const vector_tpl<koord3d> &get_route() const { return route; }
+
+	/// @returns cost of the route found
+	uint32 get_route_cost() const { return route_cost; }
+
+private:
+	static karte_ptr_t welt;
+
+	struct node_t {
+		koord3d pos;
+		uint32 parent;   ///< index in nodes, or NONE
+		uint32 g;        ///< costs so far
+		ribi_t::ribi dir;
+		uint8 flags;     ///< build_straight, build_tunnel_bridge
+	};
+
+	/// entry in the open list, smallest f first
+	struct open_node_t {
+		uint32 f;
+		uint32 index;
+		uint32 operator * () const { return f; }
+	};
+
+	enum {
+		NONE = 0xFFFFFFFFu,
+		build_straight = 1 << 0,      ///< next step has to be straight
+		build_tunnel_bridge = 1 << 1  ///< bridge or tunnel ends here
+	};
+
+	bool init_search();
+	void finish_search(state_t result, uint32 target_index);
+	void expand(uint32 index, const grund_t *gr);
+	void add_node(uint32 parent, const grund_t *to, uint32 g, ribi_t::ribi dir, uint8 flags);
+	uint32 estimate(koord3d pos) const;
+
+	way_builder_t bob;
+	const way_desc_t *desc;
+	const bridge_desc_t *bridge_desc;
+	const tunnel_desc_t *tunnel_desc;
+	costs_t costs;
+
+	vector_tpl<koord3d> starts;
+	vector_tpl<koord3d> targets;
+	koord3d mini, maxi;
+
+	state_t state;
+	vector_tpl<node_t> nodes;
+	binary_heap_tpl<open_node_t> open;
+	marker_t *closed;
+	koord closed_size; ///< world size when the search started
+	uint8 rotation;    ///< world rotation when the search started
+	uint32 expanded;
+
+	vector_tpl<koord3d> route;
+	uint32 route_cost;
+};
+
+#endif
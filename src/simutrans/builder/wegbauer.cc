@@ -12,6 +12,7 @@
 #include "../simmesg.h"
 #include "../simintr.h"
 #include "../player/simplay.h"
+#include "../player/ai_scripted.h"
 #include "../world/simplan.h"
 #include "../obj/depot.h"
 
@@ -139,7 +140,7 @@ bool way_builder_t::register_desc(way_desc_t *desc)
 
 const vector_tpl<const way_desc_t *>&  way_builder_t::get_way_list(const waytype_t wtyp, systemtype_t styp)
 {
-	static vector_tpl<const way_desc_t *> dummy;
+	static thread_local vector_tpl<const way_desc_t *> dummy;
 	dummy.clear();
 	const uint16 time = welt->get_timeline_year_month();
 	for(auto const& i : desc_table) {
@@ -541,6 +542,8 @@ bool way_builder_t::is_allowed_step(const grund_t *from, const grund_t *to, sint
 	// fake empty elevated tiles
 	static monorailboden_t from_dummy(koord3d::invalid, slope_t::flat);
 	static monorailboden_t to_dummy(koord3d::invalid, slope_t::flat);
+	// the dummies are shared, scripts may search in parallel
+	ai_scripted_t::parallel_lock_t lock( (bautyp & elevated_flag) != 0 );
 
 	if (desc == NULL) {
 		return false;
@@ -2293,6 +2296,8 @@ const char *way_builder_t::calc_route(const koord3d &start, const koord3d &ziel)
 
 const char *way_builder_t::calc_route(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel)
 {
+	// nodes, queues and markers are shared, scripts may run in parallel
+	ai_scripted_t::parallel_lock_t lock;
 #ifdef DEBUG_ROUTES
 uint32 ms = dr_time();
 #endif
@@ -26,6 +26,8 @@ class tool_selector_t;
  */
 class way_builder_t
 {
+	friend class way_pathfinder_t; ///< for the bridge and tunnel search
+
 	static karte_ptr_t welt;
 
 public:
@@ -50,6 +52,7 @@ public:
 
 	static bool waytype_available( const waytype_t wtyp, uint16 time );
 
+	/// @returns available ways, the list belongs to the calling thread and is refilled by its next call
 	static const vector_tpl<const way_desc_t *>&  get_way_list(waytype_t, systemtype_t system_type);
 
 	/**
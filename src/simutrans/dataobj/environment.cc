@@ -158,6 +158,7 @@ bool env_t::remember_window_positions;
 bool env_t::window_frame_active;
 log_t::level_t env_t::verbose_debug;
 bool env_t::pakset_debug = false;
+bool env_t::script_cache = true;
 uint8 env_t::default_sortmode;
 uint32 env_t::default_mapmode;
 uint8 env_t::show_month;
@@ -169,6 +170,9 @@ uint32 env_t::fps;
 uint32 env_t::ff_fps;
 sint16 env_t::max_acceleration;
 uint8 env_t::num_threads;
+bool env_t::parallel_ai_scripts = false;
+uint32 env_t::image_cache_size;
+bool env_t::script_profile = false;
 bool env_t::show_tooltips;
 rgb888_t env_t::tooltip_color_rgb;
 PIXVAL env_t::tooltip_color;
@@ -306,6 +310,8 @@ void env_t::init()
 	num_threads = 1;
 #endif
 
+	image_cache_size = 1024;
+
 	sound_distance_scaling = 10;
 
 	show_tooltips = true;
@@ -447,9 +447,18 @@ public:
 	/// number of threads to use (if MULTI_THREAD defined)
 	static uint8 num_threads;
 
+	/// if set, scripted ais step in parallel using up to num_threads threads
+	static bool parallel_ai_scripts;
+
+	/// memory for player coloured and day/night images in MB, 0 for unlimited
+	static uint32 image_cache_size;
+
 	/// false to quit the programs
 	static bool quit_simutrans;
 
+	/// record opcodes and time of script functions, see script_vm_t::write_profile()
+	static bool script_profile;
+
 	/// @} end of Settings to control the simulation
 
 
@@ -487,6 +496,9 @@ public:
 	/// if set, dump pakset details
 	static bool pakset_debug;
 
+	/// if set, keep compiled scripts in the user directory
+	static bool script_cache;
+
 	/// do autosave every month?
 	static sint32 autosave;
 
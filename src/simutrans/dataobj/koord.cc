@@ -157,7 +157,7 @@ void koord::rdwr(loadsave_t *file)
 // for debug messages...
 const char *koord::get_str() const
 {
-	static char pos_str[32];
+	static thread_local char pos_str[32];
 	if(x==-1  &&  y==-1) {
 		return "koord invalid";
 	}
@@ -168,7 +168,7 @@ const char *koord::get_str() const
 
 const char *koord::get_fullstr() const
 {
-	static char pos_str[32];
+	static thread_local char pos_str[32];
 	if(x==-1  &&  y==-1) {
 		return "koord invalid";
 	}
@@ -36,7 +36,6 @@ class marker_t {
 	ptrhashtable_tpl <const grund_t *, bool> more;
 
 	marker_t() : bits(NULL) { init(0, 0); }
-	~marker_t();
 
 	/**
 	 * Initializes marker. Set all tiles to not marked.
@@ -49,6 +48,10 @@ class marker_t {
 	static marker_t the_instance;
 	static marker_t second_instance;
 public:
+	/// Own marker, for searches that cannot use the shared instances
+	marker_t(int world_size_x, int world_size_y) : bits(NULL), bits_length(0) { init(world_size_x, world_size_y); }
+	~marker_t();
+
 	/**
 	 * Return handle to marker instance.
 	 * @param world_size_x x-size of map
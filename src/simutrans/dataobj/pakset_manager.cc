@@ -21,6 +21,10 @@
 #include "../dataobj/environment.h"
 #include "../network/pakset_info.h"
 
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+#endif
+
 
 pakset_manager_t::obj_map_t*                                  pakset_manager_t::registered_readers;
 inthashtable_tpl<obj_type, stringhashtable_tpl<obj_desc_t*> > pakset_manager_t::loaded;
@@ -31,6 +35,58 @@ stringhashtable_tpl<missing_level_t>                          pakset_manager_t::
 std::string                                                   pakset_manager_t::overlaid_warning;
 
 
+#ifdef MULTI_THREAD
+/// how many files the loader threads may map ahead of the parser
+#define PAK_PREFETCH_AHEAD (64)
+
+/**
+ * Maps the pak files of one directory ahead of the parser.
+ * The threads only open and page in files; parsing and registering
+ * stays on the main thread in file order, so the result is the same
+ * as loading everything sequentially.
+ */
+struct pak_prefetch_t
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+
+	char *const *names;
+	pak_file_t *files;
+	bool *ready;
+	sint32 count;
+	sint32 next;     ///< next file to be claimed by a loader thread
+	sint32 parsed;   ///< files before this one are done and unmapped
+
+	static void *loader_thread(void *ptr)
+	{
+		pak_prefetch_t *pf = reinterpret_cast<pak_prefetch_t *>(ptr);
+
+		pthread_mutex_lock( &pf->mutex );
+		while(  true  ) {
+			while(  pf->next < pf->count  &&  pf->next >= pf->parsed + PAK_PREFETCH_AHEAD  ) {
+				pthread_cond_wait( &pf->cond, &pf->mutex );
+			}
+			if(  pf->next >= pf->count  ) {
+				break;
+			}
+			const sint32 i = pf->next++;
+			pthread_mutex_unlock( &pf->mutex );
+
+			if(  pf->files[i].open( pf->names[i] )  ) {
+				pf->files[i].prefetch();
+			}
+
+			pthread_mutex_lock( &pf->mutex );
+			pf->ready[i] = true;
+			pthread_cond_broadcast( &pf->cond );
+		}
+		pthread_mutex_unlock( &pf->mutex );
+		return NULL;
+	}
+};
+#endif
+
+
 static const char* missing_level_to_string[MISSING_WAY + 1] = {
 	"",
 	"factory",
@@ -159,6 +215,67 @@ bool pakset_manager_t::load_paks_from_directory(const std::string &path, bool lo
 
 DBG_MESSAGE("pakset_manager_t::load_paks_from_directory", "Reading from '%s'", path.c_str());
 
+#ifdef MULTI_THREAD
+	pak_prefetch_t pf;
+	pthread_mutex_init( &pf.mutex, NULL );
+	pthread_cond_init( &pf.cond, NULL );
+	pf.names = find.begin();
+	pf.count = find.end() - find.begin();
+	pf.files = new pak_file_t[pf.count];
+	pf.ready = new bool[pf.count];
+	pf.next = 0;
+	pf.parsed = 0;
+	for(  sint32 i = 0;  i < pf.count;  i++  ) {
+		pf.ready[i] = false;
+	}
+
+	// loading is mostly waiting for the disk, so use all threads for it
+	const int num_loaders = clamp( (int)pf.count, 1, (int)env_t::num_threads );
+	pthread_t loader[MAX_THREADS];
+	for(  int t = 0;  t < num_loaders;  t++  ) {
+		if(  pthread_create( &loader[t], NULL, pak_prefetch_t::loader_thread, (void *)&pf )  ) {
+			dbg->fatal( "pakset_manager_t::load_paks_from_directory()", "cannot multithread, error at thread #%i", t+1 );
+		}
+	}
+
+	for(  sint32 i = 0;  i < pf.count;  i++  ) {
+		pthread_mutex_lock( &pf.mutex );
+		while(  !pf.ready[i]  ) {
+			pthread_cond_wait( &pf.cond, &pf.mutex );
+		}
+		pthread_mutex_unlock( &pf.mutex );
+
+		bool ok;
+		if(  pf.files[i].is_open()  ) {
+			ok = read_pak_file( &pf.files[i], pf.names[i] );
+		}
+		else {
+			dbg->error("pakset_manager_t::load_pak_file", "Reading '%s' failed!", pf.names[i]);
+			ok = false;
+		}
+		if(  !ok  ) {
+			dbg->warning("pakset_manager_t::load_paks_from_directory", "Cannot load '%s', some objects might be unavailable!", pf.names[i]);
+		}
+		pf.files[i].close();
+
+		pthread_mutex_lock( &pf.mutex );
+		pf.parsed = i + 1;
+		pthread_cond_broadcast( &pf.cond );
+		pthread_mutex_unlock( &pf.mutex );
+
+		if ((i & step) == 0 && drawing) {
+			ls.set_progress(i + 1);
+		}
+	}
+
+	for(  int t = 0;  t < num_loaders;  t++  ) {
+		pthread_join( loader[t], NULL );
+	}
+	pthread_cond_destroy( &pf.cond );
+	pthread_mutex_destroy( &pf.mutex );
+	delete [] pf.ready;
+	delete [] pf.files;
+#else
 	uint n = 0;
 	for (char* const& pak_filename : find) {
 		if (!load_pak_file(pak_filename)) {
@@ -169,6 +286,7 @@ DBG_MESSAGE("pakset_manager_t::load_paks_from_directory", "Reading from '%s'", p
 			ls.set_progress(n);
 		}
 	}
+#endif
 
 	ls.set_progress(max);
 	return find.begin()!=find.end();
@@ -177,57 +295,48 @@ DBG_MESSAGE("pakset_manager_t::load_paks_from_directory", "Reading from '%s'", p
 
 bool pakset_manager_t::load_pak_file(const std::string &filename)
 {
-	// added trace
-	PAKSET_INFO("loading", "name=%s", filename.c_str());
-
-	FILE* const fp = dr_fopen(filename.c_str(), "rb");
-	if (!fp) {
+	pak_file_t file;
+	if (!file.open(filename.c_str())) {
 		dbg->error("pakset_manager_t::load_pak_file", "Reading '%s' failed!", filename.c_str());
 		return false;
 	}
 
-	// This is the normal header reading code
-	int c;
-	uint32 n = 0;
+	return read_pak_file(&file, filename.c_str());
+}
+
 
-	do {
-		c = fgetc(fp);
-		n ++;
-	} while(c != EOF && c != 0x1a);
+bool pakset_manager_t::read_pak_file(pak_file_t *fp, const char *filename)
+{
+	// added trace
+	PAKSET_INFO("loading", "name=%s", filename);
 
-	if(c == EOF) {
-		dbg->error("pakset_manager_t::load_pak_file", "Unexpected end of file after %u bytes while reading '%s'!", n, filename.c_str());
-		fclose(fp);
+	// This is the normal header reading code: text up to the first ^Z
+	if (!fp->skip_past(0x1a)) {
+		dbg->error("pakset_manager_t::load_pak_file", "Unexpected end of file after %u bytes while reading '%s'!", (uint32)fp->get_size(), filename);
 		return false;
 	}
 
 	// Compiled Version
-	char dummy[4];
-	n = fread(dummy, 4, 1, fp);
-	if (n != 1) {
-		fclose(fp);
+	char *p = (char *)fp->read(4);
+	if (!p) {
 		return false;
 	}
 
-	char *p = dummy;
 	const uint32 version = decode_uint32(p);
 
-	PAKSET_INFO("pakset_manager_t::load_pak_file", "%s, reading %u blocks, file version is %x", filename.c_str(), n, version);
+	PAKSET_INFO("pakset_manager_t::load_pak_file", "%s, file version is %x", filename, version);
 
 	if(version <= COMPILER_VERSION_CODE) {
 		obj_desc_t *data = NULL;
 		if (!read_nodes(fp, data, 0, version)) {
-			fclose(fp);
 			return false;
 		}
 	}
 	else {
-		dbg->warning("pakset_manager_t::load_pak_file", "Version of '%s' is too old, %u instead of %u", filename.c_str(), version, COMPILER_VERSION_CODE );
-		fclose(fp);
+		dbg->warning("pakset_manager_t::load_pak_file", "Version of '%s' is too old, %u instead of %u", filename, version, COMPILER_VERSION_CODE );
 		return false;
 	}
 
-	fclose(fp);
 	return true;
 }
 
@@ -328,21 +437,21 @@ void pakset_manager_t::warn_if_paks_missing()
 }
 
 
-static bool read_node_info(obj_node_info_t& node, FILE* const f, uint32 const version)
+static bool read_node_info(obj_node_info_t& node, pak_file_t* const f, uint32 const version)
 {
-	char data[EXT_OBJ_NODE_INFO_SIZE];
-	if (fread(data, OBJ_NODE_INFO_SIZE, 1, f) != 1) {
+	char *p = (char *)f->read(OBJ_NODE_INFO_SIZE);
+	if (!p) {
 		return false;
 	}
 
-	char *p = data;
 	node.type      = decode_uint32(p);
 	node.nchildren = decode_uint16(p);
 	node.size      = decode_uint16(p);
 
 	// can have larger records
 	if (version != COMPILER_VERSION_CODE_11 && node.size == LARGE_RECORD_SIZE) {
-		if (fread(p, sizeof(data) - OBJ_NODE_INFO_SIZE, 1, f) != 1) {
+		p = (char *)f->read(EXT_OBJ_NODE_INFO_SIZE - OBJ_NODE_INFO_SIZE);
+		if (!p) {
 			return false;
 		}
 		node.size = decode_uint32(p);
@@ -352,7 +461,7 @@ static bool read_node_info(obj_node_info_t& node, FILE* const f, uint32 const ve
 }
 
 
-bool pakset_manager_t::read_nodes(FILE *fp, obj_desc_t *&data, int node_depth, uint32 version)
+bool pakset_manager_t::read_nodes(pak_file_t *fp, obj_desc_t *&data, int node_depth, uint32 version)
 {
 	obj_node_info_t node;
 	if (!read_node_info(node, fp, version)) {
@@ -391,7 +500,7 @@ bool pakset_manager_t::read_nodes(FILE *fp, obj_desc_t *&data, int node_depth, u
 	else {
 		// no reader found ...
 		dbg->warning("pakset_manager_t::read_nodes", "Skipping unknown %.4s-node\n", reinterpret_cast<const char *>(&node.type));
-		if (fseek(fp, node.size, SEEK_CUR) != 0) {
+		if (!fp->read(node.size)) {
 			return false;
 		}
 
@@ -408,14 +517,14 @@ bool pakset_manager_t::read_nodes(FILE *fp, obj_desc_t *&data, int node_depth, u
 }
 
 
-bool pakset_manager_t::skip_nodes(FILE *fp,uint32 version)
+bool pakset_manager_t::skip_nodes(pak_file_t *fp,uint32 version)
 {
 	obj_node_info_t node;
 	if (!read_node_info(node, fp, version)) {
 		return false;
 	}
 
-	if (fseek(fp, node.size, SEEK_CUR) != 0) {
+	if (!fp->read(node.size)) {
 		return false;
 	}
 
@@ -15,6 +15,7 @@
 
 class obj_desc_t;
 class obj_reader_t;
+class pak_file_t;
 
 
 /// Missing things during loading:
@@ -53,8 +54,11 @@ class pakset_manager_t
 	/// @param[out] data If reading is successful, contains descriptor for the object, else NULL.
 	/// @param register_nodes Nesting level for desc-nodes, should normally be 0
 	/// @param version File format version
-	static bool read_nodes(FILE *fp, obj_desc_t *&data, int register_nodes, uint32 version);
-	static bool skip_nodes(FILE *fp, uint32 version);
+	static bool read_nodes(pak_file_t *fp, obj_desc_t *&data, int register_nodes, uint32 version);
+	static bool skip_nodes(pak_file_t *fp, uint32 version);
+
+	/// Parses header and all nodes of an already opened pak file.
+	static bool read_pak_file(pak_file_t *fp, const char *filename);
 
 	static std::string doublettes;
 	static std::string overlaid_warning;
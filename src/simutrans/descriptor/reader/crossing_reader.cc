@@ -30,7 +30,7 @@ void crossing_reader_t::register_obj(obj_desc_t *&data)
 }
 
 
-obj_desc_t * crossing_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * crossing_reader_t::read_node(pak_file_t *fp, obj_node_info_t &node)
 {
 	node_body_t p(fp, node.size, get_type_name());
 	if (!p) return NULL;
@@ -23,7 +23,7 @@ protected:
 
 public:
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(pak_file_t *fp, obj_node_info_t &node) OVERRIDE;
 };
 
 
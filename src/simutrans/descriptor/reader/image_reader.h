@@ -19,7 +19,7 @@ class image_reader_t : public obj_reader_t
 
 public:
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(pak_file_t *fp, obj_node_info_t &node) OVERRIDE;
 
 private:
 	bool image_has_valid_data(image_t *img) const;
@@ -3,15 +3,89 @@
  * (see LICENSE.txt)
  */
 
+#include <string.h>
+#include <stdlib.h>
+
 #include "obj_reader.h"
+#include "../../sys/simsys.h"
+
+
+bool pak_file_t::open(const char *filename)
+{
+	close();
+
+	data = (uint8 *)dr_map_file(filename, size);
+	if (data) {
+		mapped = true;
+		return true;
+	}
+
+	// no mapping possible: read it in one go
+	FILE *fp = dr_fopen(filename, "rb");
+	if (!fp) {
+		return false;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	const long len = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	if (len > 0) {
+		data = (uint8 *)malloc(len);
+		if (fread(data, len, 1, fp) == 1) {
+			size = len;
+		}
+		else {
+			free(data);
+			data = NULL;
+		}
+	}
+	fclose(fp);
+
+	return data != NULL;
+}
+
+
+void pak_file_t::close()
+{
+	if (data) {
+		if (mapped) {
+			dr_unmap_file(data, size);
+		}
+		else {
+			free(data);
+		}
+	}
+	data = NULL;
+	size = pos = 0;
+	mapped = false;
+}
+
+
+void pak_file_t::prefetch() const
+{
+	if (!mapped) {
+		return; // already in memory
+	}
+
+	// one read per page is enough to fault it in
+	uint8 sum = 0;
+	for (size_t i = 0; i < size; i += 4096) {
+		sum += data[i];
+	}
+	volatile uint8 keep = sum;
+	(void)keep;
+}
 
-size_t node_body_t::buf_size = 0;
-uint8* node_body_t::buf = 0;
-uint8* node_body_t::ptr = 0;
-uint8* node_body_t::end = 0;
-const char* node_body_t::type_name_ = 0;
 
-#if DEBUG
-uint8 node_body_t::usage = 0;
-#endif
+bool pak_file_t::skip_past(uint8 c)
+{
+	const uint8 *found = (const uint8 *)memchr(data + pos, c, size - pos);
+	if (!found) {
+		pos = size;
+		return false;
+	}
 
+	pos = (found - data) + 1;
+	return true;
+}
@@ -97,46 +97,73 @@ inline uint64 decode_uint64(char *&data)
 		static classname the_instance
 
 
-/// Owns one pak node's bytes and a bounds-checked cursor over them.
+/// A complete pak file in memory, memory-mapped where the OS supports it.
+/// Nodes are consumed front to back; node bodies point directly into the file data.
+class pak_file_t
+{
+public:
+	pak_file_t() : data(NULL), size(0), pos(0), mapped(false) {}
+	~pak_file_t() { close(); }
+
+	/// Maps @p filename, falls back to reading it completely.
+	/// @returns false if the file cannot be opened or is empty
+	bool open(const char *filename);
+
+	void close();
+
+	bool is_open() const { return data != NULL; }
+
+	/// Touches every page, so the OS reads the file now. Safe to call from other threads.
+	void prefetch() const;
+
+	/// @returns the next @p n bytes and advances past them, or NULL if the file is shorter
+	uint8 *read(size_t n)
+	{
+		if (n > size - pos) {
+			return NULL;
+		}
+		uint8 *p = data + pos;
+		pos += n;
+		return p;
+	}
+
+	/// Advances past the next occurrence of @p c. @returns false if there is none
+	bool skip_past(uint8 c);
+
+	size_t get_pos() const { return pos; }
+	size_t get_size() const { return size; }
+
+private:
+	pak_file_t(const pak_file_t &);
+	pak_file_t &operator=(const pak_file_t &);
+
+	uint8 *data;
+	size_t size;
+	size_t pos;
+	bool mapped;
+};
+
+
+/// Bounds-checked cursor over one pak node's bytes, which stay in the pak_file_t.
 /// decode_*(node_body_t&) overloads read through it.
 class node_body_t
 {
 public:
-	/// fread @p size bytes from @p fp; short read leaves a bool-false cursor.
-	node_body_t(FILE* fp, size_t size, const char* type_name)
+	/// Takes the next @p size bytes from @p fp; running past the end of the file is fatal.
+	node_body_t(pak_file_t *fp, size_t size, const char* type_name)
 	{
 		type_name_ = type_name;
-		if (size > 0) {
-			if (size > buf_size) {
-				buf_size = size | 0x0FFF;
-				buf = (uint8*)realloc(buf,buf_size);
-			}
-			ptr = buf;
-			size_t n = fread(ptr, 1, size, fp);
-			if (n != size) {
-				dbg->fatal("node_body_t()", "Cannot read %lu (only %lu) for %s", size, n, type_name);
-			}
-			end = ptr + size;
-#if DEBUG
-			usage++;
-#endif
+		buf = ptr = fp->read(size);
+		if (!ptr) {
+			dbg->fatal("node_body_t()", "Cannot read %lu (only %lu) for %s", size, fp->get_size() - fp->get_pos(), type_name);
 		}
-		else {
-			end = ptr = buf;
+		end = ptr + size;
+		if (size == 0) {
 			dbg->error("node_body_t()", "Node of size 0 requested for %s", type_name);
 		}
 	}
 
-#if DEBUG
-	~node_body_t() {
-		usage--;
-		if (usage) {
-			dbg->fatal("node_body_t()", "is not reentrant for %s", type_name_);
-		}
-	}
-#endif
-
-	/// false on short fread.
+	/// false if the node could not be read.
 	explicit operator bool() const { return ptr != NULL; }
 
 	/// Bounds-checked `p += n`.
@@ -244,14 +271,10 @@ private:
 		return 0;
 	}
 
-#if DEBUG
-	static uint8 usage;
-#endif
-	static size_t buf_size;
-	static uint8* buf;
-	static uint8* ptr;
-	static uint8* end;
-	static const char* type_name_;
+	uint8* buf;
+	uint8* ptr;
+	uint8* end;
+	const char* type_name_;
 };
 
 /// decode_*(node_body_t&) overloads, chosen over the char*& ones by
@@ -271,7 +294,7 @@ public:
 public:
 	/// Read a descriptor from @p fp. Does version check and compatibility transformations.
 	/// @returns The descriptor on success, or NULL on failure
-	virtual obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) = 0;
+	virtual obj_desc_t *read_node(pak_file_t *fp, obj_node_info_t &node) = 0;
 
 	/// Register descriptor so the object described by the descriptor can be built in-game.
 	virtual void register_obj(obj_desc_t *&/*desc*/) {}
@@ -37,7 +37,7 @@ bool roadsign_reader_t::successfully_loaded() const
 }
 
 
-obj_desc_t *roadsign_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *roadsign_reader_t::read_node(pak_file_t *fp, obj_node_info_t &node)
 {
 	node_body_t p(fp, node.size, get_type_name());
 	if (!p) return NULL;
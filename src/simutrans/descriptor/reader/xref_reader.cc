@@ -12,7 +12,7 @@
 #include "../obj_node_info.h"
 
 
-obj_desc_t *xref_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *xref_reader_t::read_node(pak_file_t *fp, obj_node_info_t &node)
 {
 	if (node.size < 5) {
 		dbg->error("xref_reader_t::read_node", "node.size %u < 5", node.size);
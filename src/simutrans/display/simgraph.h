@@ -95,6 +95,16 @@ enum simgraph_type_t
 };
 
 
+/// Usage of the cache for recoloured (player colour and day/night) images
+struct image_cache_stats_t
+{
+	uint64 size;   ///< bytes in use
+	uint64 budget; ///< bytes allowed, 0 for unlimited
+	uint32 hits;   ///< recoloured images reused in the last frame
+	uint32 misses; ///< recoloured images computed in the last frame
+};
+
+
 /// Graphics renderer interface
 struct simgraph_t
 {
@@ -149,6 +159,9 @@ struct simgraph_t
 	int (*zoom_factor_up)();
 	int (*zoom_factor_down)();
 
+	/// Waits until the images are rezoomed after a zoom change
+	void (*finish_rezoom)();
+
 	/// Initialises the graphics module
 	bool (*init)(scr_size window_size, sint16 fullscreen);
 
@@ -173,6 +186,9 @@ struct simgraph_t
 	// delete all images above a certain number ...
 	void (*free_all_images_above)(image_id above);
 
+	/// Usage of the recoloured image cache
+	void (*get_image_cache_stats)(image_cache_stats_t &stats);
+
 	/// unzoomed offsets
 	scr_rect (*get_base_image_offset)(image_id image);
 
@@ -371,6 +387,10 @@ struct simgraph_t
 	/// @note For simgraph0 this is a no-op (as there is no display)
 	bool (*take_screenshot)(const scr_rect &screen_area);
 
+	/// Checksum over the pixels of @p screen_area, to compare the output of two renderer versions.
+	/// @note For simgraph0 this is always 0
+	uint32 (*get_screen_checksum)(const scr_rect &screen_area);
+
 	//
 	// Clipping
 	//
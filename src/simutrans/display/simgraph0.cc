@@ -23,6 +23,7 @@ static void            simgraph0_set_daynight_level         (int night);
 static scr_coord_val   simgraph0_set_base_raster_width      (scr_coord_val new_raster);
 static int             simgraph0_zoom_factor_up             ();
 static int             simgraph0_zoom_factor_down           ();
+static void            simgraph0_finish_rezoom              ();
 static bool            simgraph0_init                       (scr_size window_size, sint16 full_screen);
 static bool            simgraph0_is_display_init            ();
 static void            simgraph0_exit                       ();
@@ -31,6 +32,7 @@ static bool            simgraph0_load_font                  (const char *fname,
 static image_id        simgraph0_get_image_count            ();
 static image_id        simgraph0_register_image             (const image_t *image_in);
 static void            simgraph0_free_all_images_above      (image_id above );
+static void            simgraph0_get_image_cache_stats      (image_cache_stats_t &stats);
 static scr_rect        simgraph0_get_base_image_offset      (image_id image);
 static scr_rect        simgraph0_get_image_offset           (image_id image);
 static void            simgraph0_mark_img_dirty             (image_id image, scr_coord_val xp, scr_coord_val yp);
@@ -88,6 +90,7 @@ static void            simgraph0_draw_filled_circle         (scr_coord_val, scr_
 static void            simgraph0_draw_bezier                (scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, const PIXVAL, scr_coord_val, scr_coord_val);
 static void            simgraph0_draw_right_triangle        (scr_coord_val, scr_coord_val, scr_coord_val, const PIXVAL, const bool);
 static bool            simgraph0_take_screenshot            (const scr_rect &);
+static uint32          simgraph0_get_screen_checksum        (const scr_rect &);
 static void            simgraph0_draw_signal_direction      (scr_coord_val, scr_coord_val, uint8, uint8, PIXVAL, PIXVAL, bool, uint8);
 static void            simgraph0_set_clip_rect              (scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val  CLIP_NUM_DEF, bool fit);
 static clip_dimension  simgraph0_get_clip_rect              (CLIP_NUM_DEF_NOUSE0);
@@ -131,6 +134,7 @@ simgraph_t g_simgraph0 = {
 	/*.set_base_raster_width       =*/ simgraph0_set_base_raster_width,
 	/*.zoom_factor_up              =*/ simgraph0_zoom_factor_up,
 	/*.zoom_factor_down            =*/ simgraph0_zoom_factor_down,
+	/*.finish_rezoom               =*/ simgraph0_finish_rezoom,
 	/*.init                        =*/ simgraph0_init,
 	/*.is_display_init             =*/ simgraph0_is_display_init,
 	/*.exit                        =*/ simgraph0_exit,
@@ -139,6 +143,7 @@ simgraph_t g_simgraph0 = {
 	/*.get_image_count             =*/ simgraph0_get_image_count,
 	/*.register_image              =*/ simgraph0_register_image,
 	/*.free_all_images_above       =*/ simgraph0_free_all_images_above,
+	/*.get_image_cache_stats       =*/ simgraph0_get_image_cache_stats,
 	/*.get_base_image_offset       =*/ simgraph0_get_base_image_offset,
 	/*.get_image_offset            =*/ simgraph0_get_image_offset,
 	/*.mark_img_dirty              =*/ simgraph0_mark_img_dirty,
@@ -197,6 +202,7 @@ simgraph_t g_simgraph0 = {
 	/*.draw_right_triangle         =*/ simgraph0_draw_right_triangle,
 	/*.draw_signal_direction       =*/ simgraph0_draw_signal_direction,
 	/*.take_screenshot             =*/ simgraph0_take_screenshot,
+	/*.get_screen_checksum         =*/ simgraph0_get_screen_checksum,
 	/*.set_clip_rect               =*/ simgraph0_set_clip_rect,
 	/*.get_clip_rect               =*/ simgraph0_get_clip_rect,
 	/*.push_clip_rect              =*/ simgraph0_push_clip_rect,
@@ -247,6 +253,10 @@ static int simgraph0_zoom_factor_down()
 	return false;
 }
 
+static void simgraph0_finish_rezoom()
+{
+}
+
 static void simgraph0_mark_rect_dirty_wc(scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val)
 {
 }
@@ -302,6 +312,12 @@ static bool simgraph0_take_screenshot(const scr_rect &)
 }
 
 
+static uint32 simgraph0_get_screen_checksum(const scr_rect &)
+{
+	return 0;
+}
+
+
 static scr_rect simgraph0_get_image_offset(image_id)
 {
 	return scr_rect{ 0, 0, 0, 0 };
@@ -526,6 +542,11 @@ static void simgraph0_free_all_images_above(image_id)
 {
 }
 
+static void simgraph0_get_image_cache_stats(image_cache_stats_t &stats)
+{
+	stats = image_cache_stats_t();
+}
+
 static void simgraph0_exit()
 {
 	dr_os_close();
@@ -6,6 +6,7 @@
 #include "simgraph.h"
 
 #include "font.h"
+#include "simgraph16_blit.h"
 
 #include "../dataobj/environment.h"
 #include "../dataobj/translator.h"
@@ -21,6 +22,7 @@
 #include "../simticker.h"
 #include "../simtypes.h"
 #include "../sys/simsys.h"
+#include "../tpl/vector_tpl.h"
 #include "../utils/simstring.h"
 #include "../utils/unicode.h"
 
@@ -44,6 +46,12 @@
 // currently just redrawing/rezooming
 static pthread_mutex_t rezoom_img_mutex[MAX_THREADS];
 static pthread_mutex_t recode_img_mutex;
+
+// rezooms the images in the background after a zoom change
+static pthread_t rezoom_thread;
+static bool rezoom_thread_running = false;
+static volatile bool rezoom_thread_stop = false;
+static uint32 rezoom_start_frame = 0; // images drawn since the frame before are rezoomed first
 #endif
 
 // to pass the extra clipnum when not needed use this
@@ -246,36 +254,21 @@ static font_t default_font;
 // needed for resizing gui
 static int default_font_numberwidth = 0;
 
+/// Pixels of one glyph row with the same alpha; fully transparent pixels are left out
+struct glyph_span_t
+{
+	uint16 row;
+	uint16 x;
+	uint16 len;
+	uint8 alpha; ///< 0..31 blended, 32 opaque
+};
 
-#define RGBMAPSIZE (0x8000+LIGHT_COUNT+MAX_PLAYER_COUNT+1024 /* 343 transparent */)
-
-// RGB 555/565 specific functions
-
-// different masks needed for RGB 555 and RGB 565 for blending
-#ifdef RGB555
-#define ONE_OUT (0x3DEF) // mask out bits after applying >>1
-#define TWO_OUT (0x1CE7) // mask out bits after applying >>2
-#define MASK_32 (0x03e0f81f) // mask out bits after transforming to 32bit
-inline PIXVAL rgb(PIXVAL r, PIXVAL g, PIXVAL b) { return (r << 10) | (g << 5) | b; }
-inline PIXVAL red(PIXVAL rgb) { return  rgb >> 10; }
-inline PIXVAL green(PIXVAL rgb) { return (rgb >> 5) & 0x1F; }
-#else
-#define ONE_OUT (0x7bef) // mask out bits after applying >>1
-#define TWO_OUT (0x39E7) // mask out bits after applying >>2
-#define MASK_32 (0x07e0f81f) // mask out bits after transforming to 32bit
-inline PIXVAL rgb(PIXVAL r, PIXVAL g, PIXVAL b) { return (r << 11) | (g << 5) | b; }
-inline PIXVAL red(PIXVAL rgb) { return rgb >> 11; }
-inline PIXVAL green(PIXVAL rgb) { return (rgb >> 5) & 0x3F; }
-#endif
-inline PIXVAL blue(PIXVAL rgb) { return  rgb & 0x1F; }
+/// the spans of all glyphs of default_font, glyph c uses glyph_spans[glyph_span_start[c] .. glyph_span_start[c+1]-1]
+static std::vector<glyph_span_t> glyph_spans;
+static std::vector<uint32> glyph_span_start;
 
-/**
- * Implement shift-and-mask for rgb values:
- * shift-right by 1 or 2, and mask it to a valid rgb number.
- */
-inline PIXVAL rgb_shr1(PIXVAL c) { return (c >> 1) & ONE_OUT; }
-inline PIXVAL rgb_shr2(PIXVAL c) { return (c >> 2) & TWO_OUT; }
 
+#define RGBMAPSIZE (0x8000+LIGHT_COUNT+MAX_PLAYER_COUNT+1024 /* 343 transparent */)
 
 /*
  * mapping tables for RGB 555 to actual output format
@@ -286,8 +279,10 @@ inline PIXVAL rgb_shr2(PIXVAL c) { return (c >> 2) & TWO_OUT; }
  * 0x8010 - 0x001F: Day&Night special colors
  * The following transparent colors are not in the colortable
  * 0x8020 - 0xFFE1: 3 4 3 RGB transparent colors in 31 transparency levels
+ *
+ * Points into the table of the current night level (see daynight_table_t).
  */
-static PIXVAL rgbmap_day_night[RGBMAPSIZE];
+static PIXVAL *rgbmap_day_night = NULL;
 
 
 /*
@@ -308,7 +303,22 @@ static PIXVAL *rgbmap_current = 0;
  * to actual output format - day&night mode
  * 16 sets of 16 colors
  */
-static PIXVAL specialcolormap_day_night[256];
+static PIXVAL *specialcolormap_day_night = NULL;
+
+
+/*
+ * The colour tables of one night level. They are calculated for all levels
+ * at the start, so changing the level only swaps pointers.
+ */
+struct daynight_table_t
+{
+	PIXVAL rgbmap[RGBMAPSIZE];
+	PIXVAL specialcolormap[256];
+};
+
+#define MAX_NIGHT_SHIFT (15)
+
+static daynight_table_t *daynight_tables[MAX_NIGHT_SHIFT+1];
 
 
 /*
@@ -345,6 +355,8 @@ struct imd {
 	sint16 base_h; // height
 
 	PIXVAL* base_data; // original image data
+
+	uint32 drawn_frame; // frame of the last drawing, to rezoom the images on screen first
 };
 
 // Flags for recoding
@@ -502,6 +514,7 @@ static void            simgraph16_set_daynight_level         (int night);
 static scr_coord_val   simgraph16_set_base_raster_width      (scr_coord_val new_raster);
 static int             simgraph16_zoom_factor_up             ();
 static int             simgraph16_zoom_factor_down           ();
+static void            simgraph16_finish_rezoom              ();
 static bool            simgraph16_init                       (scr_size window_size, sint16 full_screen);
 static bool            simgraph16_is_display_init            ();
 static void            simgraph16_exit                       ();
@@ -510,6 +523,7 @@ static bool            simgraph16_load_font                  (const char *fname,
 static image_id        simgraph16_get_image_count            ();
 static image_id        simgraph16_register_image             (const image_t *image_in);
 static void            simgraph16_free_all_images_above      (image_id above );
+static void            simgraph16_get_image_cache_stats      (image_cache_stats_t &stats);
 static scr_rect        simgraph16_get_base_image_offset      (image_id image);
 static scr_rect        simgraph16_get_image_offset           (image_id image);
 static void            simgraph16_mark_img_dirty             (image_id image, scr_coord_val xp, scr_coord_val yp);
@@ -567,6 +581,7 @@ static void            simgraph16_draw_filled_circle         (scr_coord_val, scr
 static void            simgraph16_draw_bezier                (scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val, const PIXVAL, scr_coord_val, scr_coord_val);
 static void            simgraph16_draw_right_triangle        (scr_coord_val, scr_coord_val, scr_coord_val, const PIXVAL, const bool);
 static bool            simgraph16_take_screenshot            (const scr_rect &);
+static uint32          simgraph16_get_screen_checksum        (const scr_rect &);
 static void            simgraph16_draw_signal_direction      (scr_coord_val, scr_coord_val, uint8, uint8, PIXVAL, PIXVAL, bool, uint8);
 static void            simgraph16_set_clip_rect              (scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val  CLIP_NUM_DEF, bool fit);
 static clip_dimension  simgraph16_get_clip_rect              (CLIP_NUM_DEF_NOUSE0);
@@ -603,6 +618,7 @@ simgraph_t g_simgraph16 = {
 	/*.set_base_raster_width       =*/ simgraph16_set_base_raster_width,
 	/*.zoom_factor_up              =*/ simgraph16_zoom_factor_up,
 	/*.zoom_factor_down            =*/ simgraph16_zoom_factor_down,
+	/*.finish_rezoom               =*/ simgraph16_finish_rezoom,
 	/*.init                        =*/ simgraph16_init,
 	/*.is_display_init             =*/ simgraph16_is_display_init,
 	/*.exit                        =*/ simgraph16_exit,
@@ -611,6 +627,7 @@ simgraph_t g_simgraph16 = {
 	/*.get_image_count             =*/ simgraph16_get_image_count,
 	/*.register_image              =*/ simgraph16_register_image,
 	/*.free_all_images_above       =*/ simgraph16_free_all_images_above,
+	/*.get_image_cache_stats       =*/ simgraph16_get_image_cache_stats,
 	/*.get_base_image_offset       =*/ simgraph16_get_base_image_offset,
 	/*.get_image_offset            =*/ simgraph16_get_image_offset,
 	/*.mark_img_dirty              =*/ simgraph16_mark_img_dirty,
@@ -669,6 +686,7 @@ simgraph_t g_simgraph16 = {
 	/*.draw_right_triangle         =*/ simgraph16_draw_right_triangle,
 	/*.draw_signal_direction       =*/ simgraph16_draw_signal_direction,
 	/*.take_screenshot             =*/ simgraph16_take_screenshot,
+	/*.get_screen_checksum         =*/ simgraph16_get_screen_checksum,
 	/*.set_clip_rect               =*/ simgraph16_set_clip_rect,
 	/*.get_clip_rect               =*/ simgraph16_get_clip_rect,
 	/*.push_clip_rect              =*/ simgraph16_push_clip_rect,
@@ -1092,6 +1110,9 @@ static void simgraph16_mark_img_dirty(image_id image, scr_coord_val xp, scr_coor
  * They are derived from a base image, which may need zooming too
  */
 
+static void start_background_rezoom();
+static void stop_background_rezoom();
+
 /**
  * Flag all images for rezoom on next draw
  */
@@ -1109,10 +1130,13 @@ void set_zoom_factor(int z)
 {
 	// do not zoom beyond 4 pixels
 	if(  (g_simgraph16.base_tile_raster_width * g_simgraph16.zoom_num[z]) / g_simgraph16.zoom_den[z] > 4  ) {
+		// the background rezoom uses zoom_factor
+		stop_background_rezoom();
 		zoom_factor = z;
 		g_simgraph16.tile_raster_width = (g_simgraph16.base_tile_raster_width * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
 		dbg->message("set_zoom_factor()", "Zoom level now %d (%i/%i)", zoom_factor, g_simgraph16.zoom_num[zoom_factor], g_simgraph16.zoom_den[zoom_factor] );
 		rezoom();
+		start_background_rezoom();
 	}
 }
 
@@ -1227,6 +1251,214 @@ static image_id simgraph16_get_image_count()
 }
 
 
+/*
+ * The recoloured data of the images (data[]) is allocated behind a header,
+ * which links it into a list ordered by the frame of last use. The drawing
+ * threads only note the entries they use first in a frame; once per frame
+ * these are moved to the front, and the least recently used entries are
+ * freed from the back until less than env_t::image_cache_size is in use. They are recoded from zoom_data or base_data when drawn again.
+ * Entries used in the current frame are never freed, so the limit may be
+ * exceeded if the screen alone needs more.
+ *
+ * A change of the night level does not flag the images for recoding. Each
+ * entry knows the level it was coloured for and is recoded when it is drawn
+ * next, so only the images on screen are recoded, but all of them before
+ * they are drawn in the new level.
+ */
+struct recode_entry_t
+{
+	recode_entry_t *prev; // used more recently
+	recode_entry_t *next; // used less recently
+	uint32 size;          // bytes including this header
+	uint32 last_used;     // frame number
+	image_id n;
+	uint8 player_nr;
+	sint8 night;          // night_shift of the colours
+};
+
+static recode_entry_t *recode_cache_head = NULL;
+static recode_entry_t *recode_cache_tail = NULL;
+static uint32 recode_cache_count = 0;
+static uint64 recode_cache_size = 0;
+static uint32 recode_cache_frame = 1;
+static uint32 recode_cache_misses = 0;
+static uint32 recode_cache_hits[MAX_THREADS]; // per drawing thread
+
+struct recode_use_t
+{
+	image_id n;
+	uint8 player_nr;
+};
+static vector_tpl<recode_use_t> recode_cache_used[MAX_THREADS]; // entries first used in this frame, per drawing thread
+static image_cache_stats_t recode_cache_stats;
+
+
+static inline recode_entry_t *get_recode_entry(PIXVAL *data)
+{
+	return ((recode_entry_t *)data) - 1;
+}
+
+
+static void recode_cache_link(recode_entry_t *e)
+{
+	e->prev = NULL;
+	e->next = recode_cache_head;
+	if(  recode_cache_head  ) {
+		recode_cache_head->prev = e;
+	}
+	else {
+		recode_cache_tail = e;
+	}
+	recode_cache_head = e;
+}
+
+
+static void recode_cache_unlink(recode_entry_t *e)
+{
+	if(  e->prev  ) {
+		e->prev->next = e->next;
+	}
+	else {
+		recode_cache_head = e->next;
+	}
+	if(  e->next  ) {
+		e->next->prev = e->prev;
+	}
+	else {
+		recode_cache_tail = e->prev;
+	}
+}
+
+
+// caller must hold recode_img_mutex
+static void recode_cache_remove(recode_entry_t *e)
+{
+	recode_cache_unlink( e );
+	images[e->n].data[e->player_nr] = NULL;
+	images[e->n].player_flags |= 1 << e->player_nr;
+	recode_cache_count--;
+	recode_cache_size -= e->size;
+	free( e );
+}
+
+
+// allocates data[player_nr] of image n; caller must hold recode_img_mutex
+static void recode_cache_alloc(const image_id n, const uint8 player_nr)
+{
+	const uint32 size = sizeof(recode_entry_t) + images[n].len * sizeof(PIXVAL);
+	recode_entry_t *e = (recode_entry_t *)MALLOCN( uint8, size );
+	e->size = size;
+	e->last_used = recode_cache_frame;
+	e->n = n;
+	e->player_nr = player_nr;
+	e->night = night_shift;
+	recode_cache_link( e );
+	recode_cache_count++;
+	recode_cache_size += size;
+	images[n].data[player_nr] = (PIXVAL *)(e + 1);
+}
+
+
+// frees all recoloured data of image n
+static void recode_cache_free(const image_id n)
+{
+#ifdef MULTI_THREAD
+	pthread_mutex_lock( &recode_img_mutex );
+#endif
+	for(  uint8 i = 0;  i < MAX_PLAYER_COUNT;  i++  ) {
+		if(  images[n].data[i] != NULL  ) {
+			recode_cache_remove( get_recode_entry( images[n].data[i] ) );
+		}
+	}
+#ifdef MULTI_THREAD
+	pthread_mutex_unlock( &recode_img_mutex );
+#endif
+}
+
+
+/// @returns true if image n must be (re)coded for player_nr before drawing
+static inline bool needs_recode(const image_id n, const uint8 player_nr)
+{
+	if(  images[n].player_flags & (1<<player_nr)  ) {
+		return true;
+	}
+	// coloured for another night level?
+	return get_recode_entry( images[n].data[player_nr] )->night != night_shift;
+}
+
+
+/// @returns the recoloured data of an image for drawing and keeps it for this frame
+static inline PIXVAL *use_recoded_img(const image_id n, const uint8 player_nr  CLIP_NUM_DEF)
+{
+	PIXVAL *sp = images[n].data[player_nr];
+	if(  sp  ) {
+		recode_entry_t *e = get_recode_entry( sp );
+		if(  e->last_used != recode_cache_frame  ) {
+			e->last_used = recode_cache_frame;
+			const recode_use_t use = { n, player_nr };
+#ifdef MULTI_THREAD
+			recode_cache_used[clip_num].append( use );
+			recode_cache_hits[clip_num]++;
+#else
+			recode_cache_used[0].append( use );
+			recode_cache_hits[0]++;
+#endif
+		}
+	}
+	return sp;
+}
+
+
+/**
+ * Called after each frame: frees the least recently used recoloured images
+ * above the budget and takes the statistics of this frame.
+ */
+static void recode_cache_trim()
+{
+#ifdef MULTI_THREAD
+	pthread_mutex_lock( &recode_img_mutex );
+#endif
+	// entries used in this frame get to the front, so the list stays ordered by last use
+	for(  int i = 0;  i < MAX_THREADS;  i++  ) {
+		for(  recode_use_t const& use : recode_cache_used[i]  ) {
+			// may have been freed by a rezoom since
+			if(  use.n < anz_images  &&  images[use.n].data[use.player_nr] != NULL  ) {
+				recode_entry_t *e = get_recode_entry( images[use.n].data[use.player_nr] );
+				recode_cache_unlink( e );
+				recode_cache_link( e );
+			}
+		}
+		recode_cache_used[i].clear();
+	}
+
+	// then the least recently used ones are freed from the back
+	const uint64 budget = (uint64)env_t::image_cache_size << 20;
+	while(  budget > 0  &&  recode_cache_size > budget  &&  recode_cache_tail->last_used != recode_cache_frame  ) {
+		recode_cache_remove( recode_cache_tail );
+	}
+
+	recode_cache_stats.size = recode_cache_size;
+	recode_cache_stats.budget = budget;
+	recode_cache_stats.hits = 0;
+	for(  int i = 0;  i < MAX_THREADS;  i++  ) {
+		recode_cache_stats.hits += recode_cache_hits[i];
+		recode_cache_hits[i] = 0;
+	}
+	recode_cache_stats.misses = recode_cache_misses;
+	recode_cache_misses = 0;
+	recode_cache_frame++;
+#ifdef MULTI_THREAD
+	pthread_mutex_unlock( &recode_img_mutex );
+#endif
+}
+
+
+static void simgraph16_get_image_cache_stats(image_cache_stats_t &stats)
+{
+	stats = recode_cache_stats;
+}
+
+
 /**
  * Handles the conversion of an image to the output color
  */
@@ -1235,20 +1467,32 @@ static void recode_img(const image_id n, const sint8 player_nr)
 	// may this image be zoomed
 #ifdef MULTI_THREAD
 	pthread_mutex_lock( &recode_img_mutex );
-	if(  (images[n].player_flags & (1<<player_nr)) == 0  ) {
+#endif
+	if(  (images[n].player_flags & (1<<player_nr)) == 0  &&  get_recode_entry( images[n].data[player_nr] )->night == night_shift  ) {
 		// other thread did already the re-code...
+#ifdef MULTI_THREAD
 		pthread_mutex_unlock( &recode_img_mutex );
+#endif
 		return;
 	}
-#endif
 	PIXVAL *src = images[n].zoom_data != NULL ? images[n].zoom_data : images[n].base_data;
 
 	if(  images[n].data[player_nr] == NULL  ) {
-		images[n].data[player_nr] = MALLOCN( PIXVAL, images[n].len );
+		recode_cache_alloc( n, player_nr );
+	}
+	else {
+		recode_entry_t *e = get_recode_entry( images[n].data[player_nr] );
+		e->last_used = recode_cache_frame;
+		// use_recoded_img() will not note it for this frame anymore
+		recode_cache_unlink( e );
+		recode_cache_link( e );
 	}
+	recode_cache_misses++;
 	// contains now the player color ...
 	activate_player_color( player_nr, true );
 	recode_img_src_target( images[n].h, src, images[n].data[player_nr] );
+	// only now, since needs_recode() reads it without the lock
+	get_recode_entry( images[n].data[player_nr] )->night = night_shift;
 	images[n].player_flags &= ~(1<<player_nr);
 #ifdef MULTI_THREAD
 	pthread_mutex_unlock( &recode_img_mutex );
@@ -1310,6 +1554,31 @@ PIXVAL inline zoomin_pixel(uint8 *p, uint8* pab, uint8 *prl, uint8* pdia)
 }
 
 
+/**
+ * Publishes the new size and data of image @p n in one go and only then
+ * frees the old ones, so the image is never seen half rezoomed.
+ * Called with the rezoom lock of @p n held.
+ */
+static void set_zoomed_img(const image_id n, sint16 x, sint16 y, sint16 w, sint16 h, uint32 len, PIXVAL *zoom_data)
+{
+	PIXVAL *old_data = images[n].zoom_data;
+
+	images[n].x = x;
+	images[n].y = y;
+	images[n].w = w;
+	images[n].h = h;
+	images[n].len = len;
+	images[n].zoom_data = zoom_data;
+
+	// the recoloured images have the old size
+	recode_cache_free( n );
+	images[n].player_flags = 0xFFFF; // recode all player colors
+	images[n].recode_flags &= ~FLAG_REZOOM;
+
+	free( old_data );
+}
+
+
 /**
  * Convert base image data to actual image size
  * Uses averages of all sampled points to get the "real" value
@@ -1327,29 +1596,9 @@ static void rezoom_img(const image_id n)
 			return;
 		}
 #endif
-		// we may need night conversion afterwards
-		images[n].player_flags = 0xFFFF; // recode all player colors
-
-		//  we recalculate the len (since it may be larger than before)
-		// thus we have to free the old caches
-		if(  images[n].zoom_data != NULL  ) {
-			free( images[n].zoom_data );
-			images[n].zoom_data = NULL;
-		}
-		for(  uint8 i = 0;  i < MAX_PLAYER_COUNT;  i++  ) {
-			if(  images[n].data[i] != NULL  ) {
-				free( images[n].data[i] );
-				images[n].data[i] = NULL;
-			}
-		}
-
 		// just restore original size?
 		if(  zoom_factor == ZOOM_NEUTRAL  ||  (images[n].recode_flags&FLAG_ZOOMABLE) == 0  ) {
 			// this we can do be a simple copy ...
-			images[n].x = images[n].base_x;
-			images[n].w = images[n].base_w;
-			images[n].y = images[n].base_y;
-			images[n].h = images[n].base_h;
 			// recalculate length
 			sint16 h = images[n].base_h;
 			PIXVAL *sp = images[n].base_data;
@@ -1363,8 +1612,7 @@ static void rezoom_img(const image_id n)
 				} while(  *sp  );
 				sp++;
 			}
-			images[n].len = (uint32)(size_t)(sp - images[n].base_data);
-			images[n].recode_flags &= ~FLAG_REZOOM;
+			set_zoomed_img( n, images[n].base_x, images[n].base_y, images[n].base_w, images[n].base_h, (uint32)(size_t)(sp - images[n].base_data), NULL );
 #ifdef MULTI_THREAD
 			pthread_mutex_unlock( &rezoom_img_mutex[n % env_t::num_threads] );
 #endif
@@ -1373,12 +1621,12 @@ static void rezoom_img(const image_id n)
 
 		// now we want to downsize the image
 		// just divide the sizes
-		images[n].x = (images[n].base_x * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
-		images[n].y = (images[n].base_y * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
-		images[n].w = (images[n].base_w * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
-		images[n].h = (images[n].base_h * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
+		const sint16 new_x = (images[n].base_x * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
+		const sint16 new_y = (images[n].base_y * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
+		const sint16 new_w = (images[n].base_w * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
+		const sint16 new_h = (images[n].base_h * g_simgraph16.zoom_num[zoom_factor]) / g_simgraph16.zoom_den[zoom_factor];
 
-		if(  images[n].h > 0  &&  images[n].w > 0  ) {
+		if(  new_h > 0  &&  new_w > 0  ) {
 			// just recalculate the image in the new size
 			PIXVAL *src = images[n].base_data;
 			PIXVAL *dest = NULL;
@@ -1770,24 +2018,23 @@ static void rezoom_img(const image_id n)
 			}
 
 			// something left?
-			images[n].w = newzoomwidth;
-			images[n].h = newzoomheight;
+			uint32 zoom_len = images[n].len;
+			PIXVAL *zoom_data = NULL;
 			if(  newzoomheight > 0  ) {
-				const size_t zoom_len = (size_t)(((uint8 *)dest) - ((uint8 *)rezoom_baseimage[n % env_t::num_threads]));
-				images[n].len = (uint32)(zoom_len / sizeof(PIXVAL));
-				images[n].zoom_data = MALLOCN(PIXVAL, images[n].len);
-				assert( images[n].zoom_data );
-				memcpy( images[n].zoom_data, rezoom_baseimage[n % env_t::num_threads], zoom_len );
+				zoom_len = (uint32)((size_t)(((uint8 *)dest) - ((uint8 *)rezoom_baseimage[n % env_t::num_threads])) / sizeof(PIXVAL));
+				zoom_data = MALLOCN(PIXVAL, zoom_len);
+				assert( zoom_data );
+				memcpy( zoom_data, rezoom_baseimage[n % env_t::num_threads], zoom_len * sizeof(PIXVAL) );
 			}
+			set_zoomed_img( n, new_x, new_y, newzoomwidth, newzoomheight, zoom_len, zoom_data );
 		}
 		else {
-//			if (images[n].w <= 0) {
+//			if (new_w <= 0) {
 //				// h=0 will be ignored, with w=0 there was an error!
 //				printf("WARNING: image%d w=0!\n", n);
 //			}
-			images[n].h = 0;
+			set_zoomed_img( n, new_x, new_y, new_w, 0, images[n].len, NULL );
 		}
-		images[n].recode_flags &= ~FLAG_REZOOM;
 #ifdef MULTI_THREAD
 		pthread_mutex_unlock( &rezoom_img_mutex[n % env_t::num_threads] );
 #endif
@@ -1795,6 +2042,66 @@ static void rezoom_img(const image_id n)
 }
 
 
+#ifdef MULTI_THREAD
+/*
+ * After a zoom change, the images visible on screen are rezoomed by the
+ * drawing threads when they are needed. This thread helps with the images
+ * drawn in the last frames first, then does all the others, so scrolling
+ * afterwards does not stall on rezooming.
+ * Since rezoom_img() locks, no image is done twice.
+ */
+static void *rezoom_thread_func(void *)
+{
+	for(  int pass = 0;  pass < 2;  pass++  ) {
+		for(  image_id n = 0;  n < anz_images  &&  !rezoom_thread_stop;  n++  ) {
+			const bool on_screen = images[n].drawn_frame != 0  &&  images[n].drawn_frame + 1 >= rezoom_start_frame;
+			if(  (images[n].recode_flags & FLAG_REZOOM)  &&  (pass == 1  ||  on_screen)  ) {
+				rezoom_img(n);
+			}
+		}
+	}
+	return NULL;
+}
+#endif
+
+
+static void start_background_rezoom()
+{
+#ifdef MULTI_THREAD
+	if(  env_t::num_threads > 1  &&  !rezoom_thread_running  ) {
+		rezoom_thread_stop = false;
+		rezoom_start_frame = recode_cache_frame;
+		rezoom_thread_running = pthread_create( &rezoom_thread, NULL, rezoom_thread_func, NULL ) == 0;
+	}
+#endif
+}
+
+
+// must be called before images[] or zoom_factor are changed
+static void stop_background_rezoom()
+{
+#ifdef MULTI_THREAD
+	if(  rezoom_thread_running  ) {
+		rezoom_thread_stop = true;
+		pthread_join( rezoom_thread, NULL );
+		rezoom_thread_running = false;
+	}
+#endif
+}
+
+
+// lets the background rezoom do all images
+static void simgraph16_finish_rezoom()
+{
+#ifdef MULTI_THREAD
+	if(  rezoom_thread_running  ) {
+		pthread_join( rezoom_thread, NULL );
+		rezoom_thread_running = false;
+	}
+#endif
+}
+
+
 
 // get next smallest size when scaling to percent
 static scr_size simgraph16_get_best_matching_size(const image_id n, sint16 zoom_percent)
@@ -1819,6 +2126,7 @@ static scr_size simgraph16_get_best_matching_size(const image_id n, sint16 zoom_
 static void simgraph16_fit_img_to_width(const image_id n, sint16 new_w)
 {
 	if(  n < anz_images  &&  images[n].base_h > 0  &&  images[n].w != new_w  ) {
+		stop_background_rezoom();
 		int old_zoom_factor = zoom_factor;
 		for(  int i=0;  i<=MAX_ZOOM_FACTOR;  i++  ) {
 			int zoom_w = (images[n].base_w * g_simgraph16.zoom_num[i]) / g_simgraph16.zoom_den[i];
@@ -1837,10 +2145,34 @@ static void simgraph16_fit_img_to_width(const image_id n, sint16 new_w)
 }
 
 
-static void calc_base_pal_from_night_shift(const int night)
+/// sets the colours of light @p i in the tables @p t for night level @p night
+static void calc_daynight_light(const int night, daynight_table_t *t, const unsigned i)
 {
 	const int night2 = min(night, 4);
 	const int day = 4 - night2;
+
+	t->specialcolormap[SPECIAL_COLOR_COUNT+i] = get_system_color( display_day_lights[i] );
+
+	const int day_R = display_day_lights[i].r;
+	const int day_G = display_day_lights[i].g;
+	const int day_B = display_day_lights[i].b;
+
+	const int night_R = display_night_lights[i].r;
+	const int night_G = display_night_lights[i].g;
+	const int night_B = display_night_lights[i].b;
+
+	const int R = (day_R * day + night_R * night2) >> 2;
+	const int G = (day_G * day + night_G * night2) >> 2;
+	const int B = (day_B * day + night_B * night2) >> 2;
+
+	PIXVAL color = get_system_color({ (uint8)max(R,0), (uint8)max(G,0), (uint8)max(B,0) });
+	t->rgbmap[0x8000 + MAX_PLAYER_COUNT + i] = color;
+}
+
+
+/// fills the colour tables @p t for night level @p night
+static void calc_daynight_table(const int night, daynight_table_t *t)
+{
 	unsigned int i;
 
 	// constant multiplier 0,66 - dark night  255 will drop to 49, 55 to 10
@@ -1865,7 +2197,7 @@ static void calc_base_pal_from_night_shift(const int night)
 		G = (int)(G * RG_night_multiplier);
 		B = (int)(B * B_night_multiplier);
 
-		rgbmap_day_night[i] = get_system_color({ (uint8)R, (uint8)G, (uint8)B });
+		t->rgbmap[i] = get_system_color({ (uint8)R, (uint8)G, (uint8)B });
 	}
 
 	// again the same but for transparent colors
@@ -1882,7 +2214,7 @@ static void calc_base_pal_from_night_shift(const int night)
 		B = (int)(B *  B_night_multiplier);
 
 		PIXVAL color = get_system_color({ (uint8)R, (uint8)G, (uint8)B });
-		rgbmap_day_night[0x8000 +MAX_PLAYER_COUNT + LIGHT_COUNT + i] = color;
+		t->rgbmap[0x8000 +MAX_PLAYER_COUNT + LIGHT_COUNT + i] = color;
 	}
 
 	// player color map (and used for map display etc.)
@@ -1891,54 +2223,36 @@ static void calc_base_pal_from_night_shift(const int night)
 		const int G = (int)(special_pal[i].g * RG_night_multiplier);
 		const int B = (int)(special_pal[i].b *  B_night_multiplier);
 
-		specialcolormap_day_night[i] = get_system_color({ (uint8)R, (uint8)G, (uint8)B });
+		t->specialcolormap[i] = get_system_color({ (uint8)R, (uint8)G, (uint8)B });
 	}
 
 	// special light colors (actually, only non-darkening greys should be used)
 	for(i=0;  i<LIGHT_COUNT;  i++  ) {
-		specialcolormap_day_night[SPECIAL_COLOR_COUNT+i] = get_system_color( display_day_lights[i] );
+		calc_daynight_light( night, t, i );
 	}
 
 	// init with black for forbidden colors
 	for(i=SPECIAL_COLOR_COUNT+LIGHT_COUNT;  i<256;  i++  ) {
-		specialcolormap_day_night[i] = 0;
+		t->specialcolormap[i] = 0;
 	}
 
 	// default player colors
 	for(i=0;  i<8;  i++  ) {
-		rgbmap_day_night[0x8000+i] = specialcolormap_day_night[player_offsets[0][0]+i];
-		rgbmap_day_night[0x8008+i] = specialcolormap_day_night[player_offsets[0][1]+i];
+		t->rgbmap[0x8000+i] = t->specialcolormap[player_offsets[0][0]+i];
+		t->rgbmap[0x8008+i] = t->specialcolormap[player_offsets[0][1]+i];
 	}
-	player_night = 0;
-
-	// Lights
-	for (i = 0; i < LIGHT_COUNT; i++) {
-		const int day_R = display_day_lights[i].r;
-		const int day_G = display_day_lights[i].g;
-		const int day_B = display_day_lights[i].b;
-
-		const int night_R = display_night_lights[i].r;
-		const int night_G = display_night_lights[i].g;
-		const int night_B = display_night_lights[i].b;
-
-		const int R = (day_R * day + night_R * night2) >> 2;
-		const int G = (day_G * day + night_G * night2) >> 2;
-		const int B = (day_B * day + night_B * night2) >> 2;
-
-		PIXVAL color = get_system_color({ (uint8)max(R,0), (uint8)max(G,0), (uint8)max(B,0) });
-		rgbmap_day_night[0x8000 + MAX_PLAYER_COUNT + i] = color;
-	}
-
-	// convert to RGB xxx
-	recode();
 }
 
 
 static void simgraph16_set_daynight_level(int night)
 {
+	night = clamp( night, 0, MAX_NIGHT_SHIFT );
 	if(  night != night_shift  ) {
 		night_shift = night;
-		calc_base_pal_from_night_shift(night);
+		rgbmap_day_night = daynight_tables[night]->rgbmap;
+		specialcolormap_day_night = daynight_tables[night]->specialcolormap;
+		// the images are recoded lazily (see recode_entry_t), this only needs the player colours of the new table
+		player_night = 0xFF;
 		simgraph16_mark_screen_dirty();
 	}
 }
@@ -1952,16 +2266,8 @@ static void simgraph16_set_player_color_scheme(const int player, const uint8 col
 		player_offsets[player][0] = col1;
 		player_offsets[player][1] = col2;
 
-		if(player==player_day  ||  player==player_night) {
-			// and recalculate map (and save it)
-			calc_base_pal_from_night_shift(0);
-			memcpy(rgbmap_all_day, rgbmap_day_night, RGBMAPSIZE * sizeof(PIXVAL));
-			if(night_shift!=0) {
-				calc_base_pal_from_night_shift(night_shift);
-			}
-			// calc_base_pal_from_night_shift resets player_night to 0
-			player_day = player_night;
-		}
+		// activate_player_color() copies the new colours into the maps
+		player_day = player_night = 0xFF;
 
 		recode();
 		simgraph16_mark_screen_dirty();
@@ -1979,6 +2285,8 @@ static image_id simgraph16_register_image(const image_t *image_in)
 		return IMG_EMPTY;
 	}
 
+	stop_background_rezoom();
+
 	if(  anz_images == alloc_images  ) {
 		if(  images==NULL  ) {
 			alloc_images = 510;
@@ -2048,6 +2356,8 @@ static image_id simgraph16_register_image(const image_t *image_in)
 	// since we do not recode them, we can work with the original data
 	image->base_data = image_in->data;
 
+	image->drawn_frame = 0;
+
 	return id;
 }
 
@@ -2056,16 +2366,13 @@ static image_id simgraph16_register_image(const image_t *image_in)
 // (mostly needed when changing climate zones)
 static void simgraph16_free_all_images_above( image_id above )
 {
+	stop_background_rezoom();
 	while(  above < anz_images  ) {
 		anz_images--;
 		if(  images[anz_images].zoom_data != NULL  ) {
 			free( images[anz_images].zoom_data );
 		}
-		for(  uint8 i = 0;  i < MAX_PLAYER_COUNT;  i++  ) {
-			if(  images[anz_images].data[i] != NULL  ) {
-				free( images[anz_images].data[i] );
-			}
-		}
+		recode_cache_free( anz_images );
 	}
 }
 
@@ -2074,12 +2381,23 @@ static void simgraph16_free_all_images_above( image_id above )
 static scr_rect simgraph16_get_image_offset(image_id image)
 {
 	if(  image < anz_images  ) {
-		return scr_rect{
+		if(  images[image].recode_flags & FLAG_REZOOM  ) {
+			rezoom_img( image );
+		}
+#ifdef MULTI_THREAD
+		// the background rezoom may just publish a new size
+		pthread_mutex_lock( &rezoom_img_mutex[image % env_t::num_threads] );
+#endif
+		const scr_rect offset{
 			images[image].x,
 			images[image].y,
 			images[image].w,
 			images[image].h
 		};
+#ifdef MULTI_THREAD
+		pthread_mutex_unlock( &rezoom_img_mutex[image % env_t::num_threads] );
+#endif
+		return offset;
 	}
 	else {
 		return scr_rect{ 0, 0, 0, 0 };
@@ -2408,6 +2726,7 @@ static void simgraph16_draw_img_aligned( const image_id n, scr_rect area, int al
 static void simgraph16_draw_img_aux(const image_id n, scr_coord_val xp, scr_coord_val yp, const sint8 player_nr_raw, const bool /*daynight*/, const bool dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  ) {
+		images[n].drawn_frame = recode_cache_frame;
 		// only use player images if needed
 		const sint8 use_player = (images[n].recode_flags & FLAG_HAS_PLAYER_COLOR) * player_nr_raw;
 		// need to go to nightmode and or re-zoomed?
@@ -2415,7 +2734,7 @@ static void simgraph16_draw_img_aux(const image_id n, scr_coord_val xp, scr_coor
 
 		if(  use_player > 0  ) {
 			// player colour images are rezoomed/recoloured in display_color_img
-			sp = images[n].data[use_player];
+			sp = use_recoded_img( n, use_player  CLIP_NUM_PAR );
 			if(  sp == NULL  ) {
 				dbg->warning("display_img_aux", "CImg[%i] %u failed!", use_player, n);
 				return;
@@ -2426,10 +2745,10 @@ static void simgraph16_draw_img_aux(const image_id n, scr_coord_val xp, scr_coor
 				rezoom_img( n );
 				recode_img( n, 0 );
 			}
-			else if(  (images[n].player_flags & 1)  ) {
+			else if(  needs_recode( n, 0 )  ) {
 				recode_img( n, 0 );
 			}
-			sp = images[n].data[0];
+			sp = use_recoded_img( n, 0  CLIP_NUM_PAR );
 			if(  sp == NULL  ) {
 				dbg->warning("display_img_aux", "Img %u failed!", n);
 				return;
@@ -2741,6 +3060,7 @@ static void display_color_img_wc_daytime(const PIXVAL* sp, scr_coord_val x, scr_
 void simgraph16_draw_color_img(const image_id n, scr_coord_val xp, scr_coord_val yp, sint8 player_nr_raw, const bool daynight, const bool dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  ) {
+		images[n].drawn_frame = recode_cache_frame;
 		// do we have to use a player nr?
 		const sint8 player_nr = (images[n].recode_flags & FLAG_HAS_PLAYER_COLOR) * player_nr_raw;
 		// first: size check
@@ -2750,7 +3070,7 @@ void simgraph16_draw_color_img(const image_id n, scr_coord_val xp, scr_coord_val
 
 		if(  daynight  ||  night_shift == 0  ) {
 			// ok, now we could use the same faster code as for the normal images
-			if(  (images[n].player_flags & (1<<player_nr))  ) {
+			if(  needs_recode( n, player_nr )  ) {
 				recode_img( n, player_nr );
 			}
 			simgraph16_draw_img_aux( n, xp, yp, player_nr, true, dirty  CLIP_NUM_PAR);
@@ -2870,16 +3190,6 @@ static void simgraph16_draw_base_img(const image_id n, scr_coord_val xp, scr_coo
 	} // number ok
 }
 
-inline PIXVAL colors_blend25(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr2(background) + rgb_shr2(foreground); }
-inline PIXVAL colors_blend50(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr1(foreground); }
-inline PIXVAL colors_blend75(PIXVAL background, PIXVAL foreground) { return rgb_shr2(background) + rgb_shr1(foreground) + rgb_shr2(foreground); }
-inline PIXVAL colors_blend_alpha32(PIXVAL background, PIXVAL foreground, int alpha)
-{
-	uint32 b = ((background << 16) | background) & MASK_32;
-	uint32 f = ((foreground << 16) | foreground) & MASK_32;
-	uint32 r = ((f * alpha + (32-alpha) * b) >> 5) & MASK_32;
-	return r | (r >> 16);
-}
 
 // Blends two colors. Possible values for alpha: 0..32
 PIXVAL display_blend_colors_alpha32(PIXVAL background, PIXVAL foreground, int alpha)
@@ -2912,20 +3222,6 @@ static PIXVAL simgraph16_blend_colors(PIXVAL background, PIXVAL foreground, int
 /* from here code for transparent images */
 typedef void (*blend_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL colour, const PIXVAL len);
 
-// templated structures to specialize for the different blend modes: 25/50/75 percent
-struct blend25_t { static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return 3 * rgb_shr2(background) + rgb_shr2(foreground); } };
-struct blend50_t { static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr1(foreground); }     };
-struct blend75_t { static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return rgb_shr2(background) + 3 * rgb_shr2(foreground); } };
-
-template<class F> void pix_blend_tpl(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = F::blend(*dest, *src);
-		dest++;
-		src++;
-	}
-}
 
 // the following 6 functions are for display_base_img_blend()
 template<class F> void pix_blend_recode_tpl(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
@@ -2938,14 +3234,6 @@ template<class F> void pix_blend_recode_tpl(PIXVAL *dest, const PIXVAL *src, con
 	}
 }
 
-template<class F> void pix_outline_tpl(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-	while (dest < end) {
-		*dest = F::blend(*dest, colour);
-		dest++;
-	}
-}
 
 // save them for easier access
 static blend_proc blend[3] = {
@@ -3068,55 +3356,9 @@ static PIXVAL get_alpha_mask(const unsigned alpha_flags)
 
 typedef void (*alpha_proc)(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL alpha_mask, const PIXVAL colour, const PIXVAL len);
 
-static void alpha(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL alpha_mask, const PIXVAL , const PIXVAL len)
-{
-	const PIXVAL *const end = dest + len;
-
-	while(  dest < end  ) {
-		// read mask components - always 15bpp
-		uint16 masked = *alphamap & alpha_mask;
-		uint16 alpha_value = (masked & 0x1f) + ((masked >> 5) & 0x1f) + ((masked >> 10) & 0x1f);
-
-		if(  alpha_value > 30  ) {
-			// opaque, just copy source
-			*dest = *src;
-		}
-		else if(  alpha_value > 0  ) {
-			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
-
-			*dest = colors_blend_alpha32(*dest, *src, alpha_value);
-		}
-
-		dest++;
-		src++;
-		alphamap++;
-	}
-}
-
-
 static void alpha_recode(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL alpha_mask, const PIXVAL , const PIXVAL len)
 {
-	const PIXVAL *const end = dest + len;
-
-	while(  dest < end  ) {
-		// read mask components - always 15bpp
-		uint16 masked = *alphamap & alpha_mask;
-		uint16 alpha_value = (masked & 0x1f) + ((masked >> 5) & 0x1f) + ((masked >> 10) & 0x1f);
-
-		if(  alpha_value > 30  ) {
-			// opaque, just copy source
-			*dest = rgbmap_current[*src];
-		}
-		else if(  alpha_value > 0  ) {
-			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
-
-			*dest = colors_blend_alpha32(*dest, rgbmap_current[*src], alpha_value);
-		}
-
-		dest++;
-		src++;
-		alphamap++;
-	}
+	alpha_recode_map(dest, src, alphamap, alpha_mask, len, rgbmap_current);
 }
 
 
@@ -3165,15 +3407,16 @@ static void display_img_alpha_wc(scr_coord_val h, const scr_coord_val xp, const
 static void simgraph16_draw_rezoomed_img_blend(const image_id n, scr_coord_val xp, scr_coord_val yp, const signed char /*player_nr*/, const FLAGGED_PIXVAL color_index, const bool /*daynight*/, const bool dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  ) {
+		images[n].drawn_frame = recode_cache_frame;
 		// need to go to nightmode and or rezoomed?
 		if(  (images[n].recode_flags & FLAG_REZOOM)  ) {
 			rezoom_img( n );
 			recode_img( n, 0 );
 		}
-		else if(  (images[n].player_flags & 1)  ) {
+		else if(  needs_recode( n, 0 )  ) {
 			recode_img( n, 0 );
 		}
-		PIXVAL *sp = images[n].data[0];
+		PIXVAL *sp = use_recoded_img( n, 0  CLIP_NUM_PAR );
 
 		// now, since zooming may have change this image
 		xp += images[n].x;
@@ -3236,18 +3479,20 @@ static void simgraph16_draw_rezoomed_img_blend(const image_id n, scr_coord_val x
 static void simgraph16_draw_rezoomed_img_alpha(const image_id n, const image_id alpha_n, const unsigned alpha_flags, scr_coord_val xp, scr_coord_val yp, const sint8 /*player_nr*/, const FLAGGED_PIXVAL color_index, const bool /*daynight*/, const bool dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  &&  alpha_n < anz_images  ) {
+		images[n].drawn_frame = recode_cache_frame;
+		images[alpha_n].drawn_frame = recode_cache_frame;
 		// need to go to nightmode and or rezoomed?
 		if(  (images[n].recode_flags & FLAG_REZOOM)  ) {
 			rezoom_img( n );
 			recode_img( n, 0 );
 		}
-		else if(  (images[n].player_flags & 1)  ) {
+		else if(  needs_recode( n, 0 )  ) {
 			recode_img( n, 0 );
 		}
 		if(  (images[alpha_n].recode_flags & FLAG_REZOOM)  ) {
 			rezoom_img( alpha_n );
 		}
-		PIXVAL *sp = images[n].data[0];
+		PIXVAL *sp = use_recoded_img( n, 0  CLIP_NUM_PAR );
 		// alphamap image uses base data as we don't want to recode
 		PIXVAL *alphamap = images[alpha_n].zoom_data != NULL ? images[alpha_n].zoom_data : images[alpha_n].base_data;
 		// now, since zooming may have change this image
@@ -3654,6 +3899,47 @@ static void simgraph16_draw_array(scr_coord_val xp, scr_coord_val yp, scr_coord_
 
 // --------------------------------- text rendering stuff ------------------------------
 
+/**
+ * Converts the glyph bitmaps into runs of equal alpha, so text drawing
+ * does not need to look at the transparent pixels around each glyph.
+ */
+static void build_glyph_spans()
+{
+	glyph_spans.clear();
+	glyph_span_start.clear();
+	glyph_span_start.reserve( default_font.glyphs.size()+1 );
+
+	for(  const font_t::glyph_t &glyph : default_font.glyphs  ) {
+		glyph_span_start.push_back( glyph_spans.size() );
+		if(  glyph.advance == 0xFF  ||  glyph.bitmap == NULL  ) {
+			continue;
+		}
+
+		for(  int h = 0;  h < glyph.height;  h++  ) {
+			const uint8 *p = glyph.bitmap + h*glyph.width;
+			int gx = 0;
+			while(  gx < glyph.width  ) {
+				const uint8 alpha = p[gx] > 31 ? 32 : p[gx];
+				if(  alpha == 0  ) {
+					gx++;
+					continue;
+				}
+				glyph_span_t span;
+				span.row = h;
+				span.x = gx;
+				span.alpha = alpha;
+				while(  gx < glyph.width  &&  (p[gx] > 31 ? 32 : p[gx]) == alpha  ) {
+					gx++;
+				}
+				span.len = gx - span.x;
+				glyph_spans.push_back( span );
+			}
+		}
+	}
+	glyph_span_start.push_back( glyph_spans.size() );
+}
+
+
 static bool simgraph16_load_font(const char *fname, bool reload)
 {
 	font_t loaded_fnt;
@@ -3672,6 +3958,7 @@ static bool simgraph16_load_font(const char *fname, bool reload)
 		default_font = loaded_fnt;
 		default_font_ascent    = default_font.get_ascent();
 		default_font_linespace = default_font.get_linespace();
+		build_glyph_spans();
 
 		// find default number width
 		const char* digits = "0123456789";
@@ -3915,36 +4202,39 @@ static scr_coord_val simgraph16_draw_text_clipped_n(scr_coord_val x, scr_coord_v
 
 		// get the data from the font
 		const font_t::glyph_t& glyph = fnt->get_glyph(c);
-		const uint8 *p = glyph.bitmap;
-
-		int screen_pos = (y + glyph.top) * disp_width + x + glyph.left;
 
-		// glyph x clipping
-		int g_left  = max(cL - x - glyph.left, 0);
-		int g_right = min(cR - x - glyph.left, glyph.width);
+		if(  c+1 < glyph_span_start.size()  ) {
+			const int gx0 = x + glyph.left;
+			const int gy0 = y + glyph.top;
 
-		// all visible rows
-		for (int h = 0; h < glyph.height; h++) {
-			const int line = y + glyph.top + h;
-			if(line >= cT && line < cB) {
-
-				PIXVAL* dst = textur + screen_pos + g_left;
+			// all visible spans
+			for(  uint32 i = glyph_span_start[c];  i < glyph_span_start[c+1];  i++  ) {
+				const glyph_span_t &span = glyph_spans[i];
+				const int line = gy0 + span.row;
+				if(  line < cT  ||  line >= cB  ) {
+					continue;
+				}
 
-				// all columns
-				for(int gx=g_left; gx<g_right; gx++) {
-					int alpha = p[h*glyph.width + gx];
+				// glyph x clipping
+				const int xl = max( gx0 + span.x, (int)cL );
+				const int xr = min( gx0 + span.x + span.len, (int)cR );
+				PIXVAL *dst = textur + line * disp_width + xl;
+				PIXVAL *const end = dst + (xr - xl);
 
-					if(alpha > 31) {
-						// opaque
+				if(  span.alpha == 32  ) {
+					// opaque
+					while(  dst < end  ) {
 						*dst++ = color;
-					} else {
-						// partially transparent -> blend it
-						PIXVAL old_color = *dst;
-						*dst++ = colors_blend_alpha32(old_color, color, alpha);
+					}
+				}
+				else {
+					// partially transparent -> blend it
+					while(  dst < end  ) {
+						*dst = colors_blend_alpha32( *dst, color, span.alpha );
+						dst++;
 					}
 				}
 			}
-			screen_pos += disp_width;
 		}
 
 		x += fnt->get_glyph_advance(c);
@@ -4484,6 +4774,8 @@ static inline uint32 get_lowest_set_bit(uint32 val)
  */
 static void simgraph16_flush_framebuffer()
 {
+	recode_cache_trim();
+
 #ifdef USE_SOFTPOINTER
 	ex_ord_update_mx_my();
 
@@ -4709,6 +5001,12 @@ static bool simgraph16_init(scr_size window_size, sint16 full_screen)
 
 	simgraph16_set_clip_rect(0, 0, disp_width, disp_height CLIP_NUM_DEFAULT, false);
 
+	// the colour tables of all night levels, so a change of the level never waits for them
+	for(  int i = 0;  i <= MAX_NIGHT_SHIFT;  i++  ) {
+		daynight_tables[i] = MALLOC( daynight_table_t );
+		calc_daynight_table( i, daynight_tables[i] );
+	}
+
 	// Calculate daylight rgbmap and save it for unshaded tile drawing
 	player_day = 0;
 	simgraph16_set_daynight_level(0);
@@ -4762,6 +5060,13 @@ static void simgraph16_exit()
 
 	tile_dirty = tile_dirty_old = NULL;
 	images = NULL;
+
+	for(  int i = 0;  i <= MAX_NIGHT_SHIFT;  i++  ) {
+		free( daynight_tables[i] );
+		daynight_tables[i] = NULL;
+	}
+	rgbmap_day_night = specialcolormap_day_night = NULL;
+	night_shift = -1;
 #ifdef MULTI_THREAD
 	pthread_mutex_destroy( &recode_img_mutex );
 	for(  int i = 0;  i < MAX_THREADS;  i++  ) {
@@ -4846,6 +5151,25 @@ static bool simgraph16_take_screenshot(const scr_rect &area)
 }
 
 
+/**
+ * FNV-1a hash of the pixels in area
+ */
+static uint32 simgraph16_get_screen_checksum(const scr_rect &area)
+{
+	scr_rect clipped_area = area;
+	clipped_area.clip(scr_rect(0, 0, disp_actual_width, disp_height));
+
+	uint32 hash = 2166136261u;
+	for (scr_coord_val y = 0; y < clipped_area.h; ++y) {
+		const PIXVAL *row = textur + clipped_area.x + (clipped_area.y + y) * disp_width;
+		for (scr_coord_val x = 0; x < clipped_area.w; ++x) {
+			hash = (hash ^ *row++) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+
 static void simgraph16_set_image_procs(bool is_global)
 {
 	if(  is_global  ) {
@@ -4869,4 +5193,15 @@ void simgraph16_set_light_color(int light_idx, rgb888_t day_colour, rgb888_t nig
 {
 	display_day_lights[light_idx]   = day_colour;
 	display_night_lights[light_idx] = night_colour;
+
+	// only this light changes in the tables
+	for(  int i = 0;  i <= MAX_NIGHT_SHIFT;  i++  ) {
+		if(  daynight_tables[i]  ) {
+			calc_daynight_light( i, daynight_tables[i], light_idx );
+		}
+	}
+	if(  daynight_tables[0]  ) {
+		specialcolormap_all_day[SPECIAL_COLOR_COUNT+light_idx] = daynight_tables[0]->specialcolormap[SPECIAL_COLOR_COUNT+light_idx];
+		rgbmap_all_day[0x8000+MAX_PLAYER_COUNT+light_idx] = daynight_tables[0]->rgbmap[0x8000+MAX_PLAYER_COUNT+light_idx];
+	}
 }
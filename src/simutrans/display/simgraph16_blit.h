@@ -0,0 +1,264 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef DISPLAY_SIMGRAPH16_BLIT_H
+#define DISPLAY_SIMGRAPH16_BLIT_H
+
+
+#include "../simcolor.h"
+#include "../simconst.h"
+#include "../simtypes.h"
+
+/*
+ * Procedures of simgraph16 that work on runs of pixels only,
+ * shared with the blitter test in src/blittest.
+ */
+
+// RGB 555/565 specific functions
+
+// different masks needed for RGB 555 and RGB 565 for blending
+#ifdef RGB555
+#define ONE_OUT (0x3DEF) // mask out bits after applying >>1
+#define TWO_OUT (0x1CE7) // mask out bits after applying >>2
+#define MASK_32 (0x03e0f81f) // mask out bits after transforming to 32bit
+inline PIXVAL rgb(PIXVAL r, PIXVAL g, PIXVAL b) { return (r << 10) | (g << 5) | b; }
+inline PIXVAL red(PIXVAL rgb) { return  rgb >> 10; }
+inline PIXVAL green(PIXVAL rgb) { return (rgb >> 5) & 0x1F; }
+#else
+#define ONE_OUT (0x7bef) // mask out bits after applying >>1
+#define TWO_OUT (0x39E7) // mask out bits after applying >>2
+#define MASK_32 (0x07e0f81f) // mask out bits after transforming to 32bit
+inline PIXVAL rgb(PIXVAL r, PIXVAL g, PIXVAL b) { return (r << 11) | (g << 5) | b; }
+inline PIXVAL red(PIXVAL rgb) { return rgb >> 11; }
+inline PIXVAL green(PIXVAL rgb) { return (rgb >> 5) & 0x3F; }
+#endif
+inline PIXVAL blue(PIXVAL rgb) { return  rgb & 0x1F; }
+
+/**
+ * Implement shift-and-mask for rgb values:
+ * shift-right by 1 or 2, and mask it to a valid rgb number.
+ */
+inline PIXVAL rgb_shr1(PIXVAL c) { return (c >> 1) & ONE_OUT; }
+inline PIXVAL rgb_shr2(PIXVAL c) { return (c >> 2) & TWO_OUT; }
+
+
+/*
+ * Vectors of SIMD_PIXELS pixels for the blending loops. SSE2 and NEON are
+ * part of every x86-64 and AArch64 CPU, so no runtime check is needed.
+ * The vector code must give exactly the same pixels as the scalar code,
+ * which still handles the remainder of each run.
+ */
+#if defined(__SSE2__)  ||  defined(_M_X64)
+#include <emmintrin.h>
+#define SIMD_PIXELS (8)
+typedef __m128i pixvec;
+static inline pixvec pv_load(const PIXVAL *p) { return _mm_loadu_si128((const __m128i *)p); }
+static inline void pv_store(PIXVAL *p, pixvec v) { _mm_storeu_si128((__m128i *)p, v); }
+static inline pixvec pv_set(PIXVAL c) { return _mm_set1_epi16((short)c); }
+static inline pixvec pv_and(pixvec a, pixvec b) { return _mm_and_si128(a, b); }
+static inline pixvec pv_add(pixvec a, pixvec b) { return _mm_add_epi16(a, b); }
+static inline pixvec pv_sub(pixvec a, pixvec b) { return _mm_sub_epi16(a, b); }
+static inline pixvec pv_mul(pixvec a, pixvec b) { return _mm_mullo_epi16(a, b); }
+static inline pixvec pv_shr(pixvec a, int n) { return _mm_srl_epi16(a, _mm_cvtsi32_si128(n)); }
+static inline pixvec pv_shl(pixvec a, int n) { return _mm_sll_epi16(a, _mm_cvtsi32_si128(n)); }
+/// lanes are all ones where a > b (for values below 0x8000)
+static inline pixvec pv_greater(pixvec a, pixvec b) { return _mm_cmpgt_epi16(a, b); }
+/// a where mask is set, else b
+static inline pixvec pv_select(pixvec mask, pixvec a, pixvec b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SIMD_PIXELS (8)
+typedef uint16x8_t pixvec;
+static inline pixvec pv_load(const PIXVAL *p) { return vld1q_u16(p); }
+static inline void pv_store(PIXVAL *p, pixvec v) { vst1q_u16(p, v); }
+static inline pixvec pv_set(PIXVAL c) { return vdupq_n_u16(c); }
+static inline pixvec pv_and(pixvec a, pixvec b) { return vandq_u16(a, b); }
+static inline pixvec pv_add(pixvec a, pixvec b) { return vaddq_u16(a, b); }
+static inline pixvec pv_sub(pixvec a, pixvec b) { return vsubq_u16(a, b); }
+static inline pixvec pv_mul(pixvec a, pixvec b) { return vmulq_u16(a, b); }
+static inline pixvec pv_shr(pixvec a, int n) { return vshlq_u16(a, vdupq_n_s16(-n)); }
+static inline pixvec pv_shl(pixvec a, int n) { return vshlq_u16(a, vdupq_n_s16(n)); }
+static inline pixvec pv_greater(pixvec a, pixvec b) { return vcgtq_u16(a, b); }
+static inline pixvec pv_select(pixvec mask, pixvec a, pixvec b) { return vbslq_u16(mask, a, b); }
+#endif
+
+#ifdef SIMD_PIXELS
+static inline pixvec rgb_shr1(pixvec c) { return pv_and(pv_shr(c, 1), pv_set(ONE_OUT)); }
+static inline pixvec rgb_shr2(pixvec c) { return pv_and(pv_shr(c, 2), pv_set(TWO_OUT)); }
+#endif
+
+
+inline PIXVAL colors_blend25(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr2(background) + rgb_shr2(foreground); }
+inline PIXVAL colors_blend50(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr1(foreground); }
+inline PIXVAL colors_blend75(PIXVAL background, PIXVAL foreground) { return rgb_shr2(background) + rgb_shr1(foreground) + rgb_shr2(foreground); }
+inline PIXVAL colors_blend_alpha32(PIXVAL background, PIXVAL foreground, int alpha)
+{
+	uint32 b = ((background << 16) | background) & MASK_32;
+	uint32 f = ((foreground << 16) | foreground) & MASK_32;
+	uint32 r = ((f * alpha + (32-alpha) * b) >> 5) & MASK_32;
+	return r | (r >> 16);
+}
+
+#if defined SIMD_PIXELS  &&  !defined RGB555
+#define SIMD_ALPHA
+/**
+ * colors_blend_alpha32() for a vector with one alpha (0..32) per pixel.
+ * In RGB565 the channels in the 32 bit word above do not overlap,
+ * so blending each channel on its own gives the same result.
+ */
+static inline pixvec colors_blend_alpha32(pixvec background, pixvec foreground, pixvec alpha)
+{
+	const pixvec inv   = pv_sub(pv_set(32), alpha);
+	const pixvec mask5 = pv_set(0x1f);
+	const pixvec mask6 = pv_set(0x3f);
+
+	const pixvec b = pv_shr(pv_add(pv_mul(pv_and(foreground, mask5), alpha), pv_mul(pv_and(background, mask5), inv)), 5);
+	const pixvec g = pv_shr(pv_add(pv_mul(pv_and(pv_shr(foreground, 5), mask6), alpha), pv_mul(pv_and(pv_shr(background, 5), mask6), inv)), 5);
+	const pixvec r = pv_shr(pv_add(pv_mul(pv_shr(foreground, 11), alpha), pv_mul(pv_shr(background, 11), inv)), 5);
+	return pv_add(pv_add(pv_shl(r, 11), pv_shl(g, 5)), b);
+}
+#endif
+
+
+// templated structures to specialize for the different blend modes: 25/50/75 percent
+struct blend25_t {
+	static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return 3 * rgb_shr2(background) + rgb_shr2(foreground); }
+#ifdef SIMD_PIXELS
+	static inline pixvec blend(pixvec background, pixvec foreground) { const pixvec b = rgb_shr2(background); return pv_add(pv_add(pv_add(b, b), b), rgb_shr2(foreground)); }
+#endif
+};
+struct blend50_t {
+	static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return rgb_shr1(background) + rgb_shr1(foreground); }
+#ifdef SIMD_PIXELS
+	static inline pixvec blend(pixvec background, pixvec foreground) { return pv_add(rgb_shr1(background), rgb_shr1(foreground)); }
+#endif
+};
+struct blend75_t {
+	static inline PIXVAL blend(PIXVAL background, PIXVAL foreground) { return rgb_shr2(background) + 3 * rgb_shr2(foreground); }
+#ifdef SIMD_PIXELS
+	static inline pixvec blend(pixvec background, pixvec foreground) { const pixvec f = rgb_shr2(foreground); return pv_add(rgb_shr2(background), pv_add(pv_add(f, f), f)); }
+#endif
+};
+
+template<class F> void pix_blend_tpl(PIXVAL *dest, const PIXVAL *src, const PIXVAL , const PIXVAL len)
+{
+	const PIXVAL *const end = dest + len;
+#ifdef SIMD_PIXELS
+	for(  ;  dest + SIMD_PIXELS <= end;  dest += SIMD_PIXELS, src += SIMD_PIXELS  ) {
+		pv_store(dest, F::blend(pv_load(dest), pv_load(src)));
+	}
+#endif
+	while (dest < end) {
+		*dest = F::blend(*dest, *src);
+		dest++;
+		src++;
+	}
+}
+
+template<class F> void pix_outline_tpl(PIXVAL *dest, const PIXVAL *, const PIXVAL colour, const PIXVAL len)
+{
+	const PIXVAL *const end = dest + len;
+#ifdef SIMD_PIXELS
+	const pixvec colour_v = pv_set(colour);
+	for(  ;  dest + SIMD_PIXELS <= end;  dest += SIMD_PIXELS  ) {
+		pv_store(dest, F::blend(pv_load(dest), colour_v));
+	}
+#endif
+	while (dest < end) {
+		*dest = F::blend(*dest, colour);
+		dest++;
+	}
+}
+
+
+#ifdef SIMD_ALPHA
+/// alpha() for SIMD_PIXELS pixels, src already recoded
+static inline void alpha_vec(PIXVAL *dest, pixvec src, const PIXVAL *alphamap, pixvec alpha_mask)
+{
+	const pixvec mask5  = pv_set(0x1f);
+	const pixvec masked = pv_and(pv_load(alphamap), alpha_mask);
+	pixvec alpha_value  = pv_add(pv_add(pv_and(masked, mask5), pv_and(pv_shr(masked, 5), mask5)), pv_and(pv_shr(masked, 10), mask5));
+
+	const pixvec opaque = pv_greater(alpha_value, pv_set(30));
+	// 16..30 => 17..31; alpha zero keeps dest unchanged in the blend
+	alpha_value = pv_sub(alpha_value, pv_greater(alpha_value, pv_set(15)));
+
+	const pixvec d = pv_load(dest);
+	pv_store(dest, pv_select(opaque, src, colors_blend_alpha32(d, src, alpha_value)));
+}
+#endif
+
+static inline void alpha(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL alpha_mask, const PIXVAL , const PIXVAL len)
+{
+	const PIXVAL *const end = dest + len;
+
+#ifdef SIMD_ALPHA
+	const pixvec alpha_mask_v = pv_set(alpha_mask);
+	for(  ;  dest + SIMD_PIXELS <= end;  dest += SIMD_PIXELS, src += SIMD_PIXELS, alphamap += SIMD_PIXELS  ) {
+		alpha_vec(dest, pv_load(src), alphamap, alpha_mask_v);
+	}
+#endif
+
+	while(  dest < end  ) {
+		// read mask components - always 15bpp
+		uint16 masked = *alphamap & alpha_mask;
+		uint16 alpha_value = (masked & 0x1f) + ((masked >> 5) & 0x1f) + ((masked >> 10) & 0x1f);
+
+		if(  alpha_value > 30  ) {
+			// opaque, just copy source
+			*dest = *src;
+		}
+		else if(  alpha_value > 0  ) {
+			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
+
+			*dest = colors_blend_alpha32(*dest, *src, alpha_value);
+		}
+
+		dest++;
+		src++;
+		alphamap++;
+	}
+}
+
+
+/// alpha() with the source recoded through @p rgbmap
+static inline void alpha_recode_map(PIXVAL *dest, const PIXVAL *src, const PIXVAL *alphamap, const PIXVAL alpha_mask, const PIXVAL len, const PIXVAL *rgbmap)
+{
+	const PIXVAL *const end = dest + len;
+
+#ifdef SIMD_ALPHA
+	const pixvec alpha_mask_v = pv_set(alpha_mask);
+	PIXVAL recoded[SIMD_PIXELS];
+	for(  ;  dest + SIMD_PIXELS <= end;  dest += SIMD_PIXELS, src += SIMD_PIXELS, alphamap += SIMD_PIXELS  ) {
+		// the lookup has no vector form
+		for(  int i = 0;  i < SIMD_PIXELS;  i++  ) {
+			recoded[i] = rgbmap[src[i]];
+		}
+		alpha_vec(dest, pv_load(recoded), alphamap, alpha_mask_v);
+	}
+#endif
+
+	while(  dest < end  ) {
+		// read mask components - always 15bpp
+		uint16 masked = *alphamap & alpha_mask;
+		uint16 alpha_value = (masked & 0x1f) + ((masked >> 5) & 0x1f) + ((masked >> 10) & 0x1f);
+
+		if(  alpha_value > 30  ) {
+			// opaque, just copy source
+			*dest = rgbmap[*src];
+		}
+		else if(  alpha_value > 0  ) {
+			alpha_value = alpha_value > 15 ? alpha_value + 1 : alpha_value;
+
+			*dest = colors_blend_alpha32(*dest, rgbmap[*src], alpha_value);
+		}
+
+		dest++;
+		src++;
+		alphamap++;
+	}
+}
+
+#endif
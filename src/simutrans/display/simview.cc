@@ -55,25 +55,36 @@ static simthread_barrier_t display_barrier_end;
 // to start a thread
 typedef struct{
 	main_view_t *show_routine;
-	koord   lt_cl, wh_cl; // pos/size of clipping rect for this thread
-	koord   lt, wh;       // pos/size of region to display. set larger than clipping for correct display of trees at thread seams
-	sint16  y_min;
-	sint16  y_max;
 	sint8   thread_num;
+} display_thread_param_t;
+
+static display_thread_param_t ka[MAX_THREADS];
+
+/*
+ * The screen is cut into more vertical stripes than there are threads. Each
+ * thread takes the next stripe not drawn yet until none is left, so threads
+ * with little to draw (e.g. water) help with the busy parts of the screen.
+ */
+#define MAX_DISPLAY_REGIONS (MAX_THREADS*4)
+
+typedef struct{
+	koord   lt_cl, wh_cl; // pos/size of clipping rect for this stripe
+	koord   lt, wh;       // pos/size of region to display. set larger than clipping for correct display of trees at stripe seams
 } display_region_param_t;
 
-// now the parameters
-static display_region_param_t ka[MAX_THREADS];
+static display_region_param_t regions[MAX_DISPLAY_REGIONS];
+static int num_regions = 0;
+static int next_region = 0;
+static sint16 regions_y_min, regions_y_max;
+static pthread_mutex_t region_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 void *display_region_thread( void *ptr )
 {
-	display_region_param_t *view = reinterpret_cast<display_region_param_t *>(ptr);
+	display_thread_param_t *view = reinterpret_cast<display_thread_param_t *>(ptr);
 
 	while(true) {
 		simthread_barrier_wait( &display_barrier_start ); // wait for all to start
-		gfx->clear_all_poly_clip( view->thread_num );
-		gfx->set_clip_rect( view->lt_cl.x, view->lt_cl.y, view->wh_cl.x, view->wh_cl.y, view->thread_num, false);
-		view->show_routine->display_region( view->lt, view->wh, view->y_min, view->y_max, false, true, view->thread_num );
+		view->show_routine->display_queued_regions( view->thread_num );
 		simthread_barrier_wait( &display_barrier_end ); // wait for all to finish
 	}
 }
@@ -226,33 +237,36 @@ void main_view_t::display(bool force_dirty)
 			pthread_attr_destroy( &attr );
 		}
 
-		// set parameter for each thread
-		const scr_coord_val wh_x = clip_rr.w / env_t::num_threads;
-		scr_coord_val lt_x = clip_rr.x;
 		for(  int t = 0;  t < env_t::num_threads - 1;  t++  ) {
 			ka[t].show_routine = this;
-			ka[t].lt_cl = koord( lt_x, clip_rr.y );
-			ka[t].wh_cl = koord( wh_x, clip_rr.h );
-			ka[t].lt = ka[t].lt_cl - koord( IMG_SIZE/2, 0 ); // process tiles IMG_SIZE/2 outside clipping range for correct tree display at thread seams
-			ka[t].wh = ka[t].wh_cl + koord( IMG_SIZE, 0 );
-			ka[t].y_min = y_min;
-			ka[t].y_max = dpy_height + 4 * 4;
 			ka[t].thread_num = t;
-			lt_x += wh_x;
 		}
 
+		// cut the screen into stripes, at least four tiles wide, since every stripe
+		// also draws the tiles half a tile beyond its edges
+		num_regions = clamp( clip_rr.w / (4 * IMG_SIZE), 1, min( env_t::num_threads * 4, MAX_DISPLAY_REGIONS ) );
+		const scr_coord_val wh_x = clip_rr.w / num_regions;
+		scr_coord_val lt_x = clip_rr.x;
+		for(  int r = 0;  r < num_regions;  r++  ) {
+			// the last one extends to the screen edge (in case clip_rr.w % num_regions != 0)
+			const scr_coord_val w = r < num_regions - 1 ? wh_x : clip_rr.x + clip_rr.w - lt_x;
+			regions[r].lt_cl = koord( lt_x, clip_rr.y );
+			regions[r].wh_cl = koord( w, clip_rr.h );
+			regions[r].lt = regions[r].lt_cl - koord( IMG_SIZE/2, 0 ); // process tiles IMG_SIZE/2 outside clipping range for correct tree display at stripe seams
+			regions[r].wh = regions[r].wh_cl + koord( IMG_SIZE, 0 );
+			lt_x += w;
+		}
+		next_region = 0;
+		regions_y_min = y_min;
+		regions_y_max = dpy_height + 4 * 4;
+
 		// init variables required to draw smart cursor
 		threads_req_pause = false;
 		num_threads_paused = 0;
 
-		// and start drawing
+		// and start drawing, the last thread is this one
 		simthread_barrier_wait( &display_barrier_start );
-
-		// the last we can run ourselves, setting clip_wh to the screen edge instead of wh_x (in case disp_width % num_threads != 0)
-		gfx->clear_all_poly_clip( env_t::num_threads - 1 );
-		gfx->set_clip_rect( lt_x, clip_rr.y, clip_rr.w, clip_rr.h, env_t::num_threads - 1, false);
-		display_region( koord( lt_x - IMG_SIZE / 2, clip_rr.y ), koord( clip_rr.x + clip_rr.w + IMG_SIZE, clip_rr.h ), y_min, dpy_height + 4 * 4, false, true, env_t::num_threads - 1 );
-
+		display_queued_regions( env_t::num_threads - 1 );
 		simthread_barrier_wait( &display_barrier_end );
 
 		gfx->clear_all_poly_clip( CLIP_NUM_DEFAULT_VALUE );
@@ -367,6 +381,39 @@ void main_view_t::clear_prepared() const
 }
 
 
+#ifdef MULTI_THREAD
+void main_view_t::display_queued_regions( const sint8 clip_num )
+{
+	while(  true  ) {
+		pthread_mutex_lock( &region_mutex );
+		const int r = next_region < num_regions ? next_region++ : -1;
+		pthread_mutex_unlock( &region_mutex );
+		if(  r < 0  ) {
+			break;
+		}
+
+		const display_region_param_t &region = regions[r];
+		gfx->clear_all_poly_clip( clip_num );
+		gfx->set_clip_rect( region.lt_cl.x, region.lt_cl.y, region.wh_cl.x, region.wh_cl.y, clip_num, false );
+		display_region( region.lt, region.wh, regions_y_min, regions_y_max, false, true, clip_num );
+	}
+
+	// show thread as paused when finished
+	pthread_mutex_lock( &hide_mutex );
+	num_threads_paused++;
+	pthread_cond_broadcast( &waiting_cond );
+	pthread_mutex_unlock( &hide_mutex );
+}
+#endif
+
+
+// advances x in steps of two to x_start, so the column parity stays the same
+static inline sint16 first_column( sint16 x, sint16 x_start )
+{
+	return x < x_start ? x + ((x_start - x) & ~1) : x;
+}
+
+
 #ifdef MULTI_THREAD
 void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max, bool /*force_dirty*/, bool threaded, const sint8 clip_num )
 #else
@@ -390,12 +437,15 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 	const koord cursor_pos = welt->get_zeiger() ? welt->get_zeiger()->get_pos().get_2d() : koord(-1000, -1000);
 	const bool needs_hiding = !env_t::hide_trees  ||  (env_t::hide_buildings != env_t::ALL_HIDDEN_BUILDING);
 
+	// tiles left of this column cannot reach into the region, so skip them
+	const sint16 x_start = (lt.x - IMG_SIZE - const_x_off) / (IMG_SIZE / 2) - 2;
+
 	for(  int y = y_min;  y < y_max;  y++  ) {
 		const sint16 ypos = y * (IMG_SIZE / 4) + const_y_off;
 		// plotted = we plotted something
 		bool plotted = false;
 
-		for(  sint16 x = -2 - ((y  +dpy_width) & 1);  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
+		for(  sint16 x = first_column( -2 - ((y + dpy_width) & 1), x_start );  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
 			const sint16 i = ((y + x) >> 1) + i_off;
 			const sint16 j = ((y - x) >> 1) + j_off;
 			const sint16 xpos = x * (IMG_SIZE / 2) + const_x_off;
@@ -471,7 +521,7 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 	for(  int y = y_min;  y < y_max;  y++  ) {
 		const sint16 ypos = y * (IMG_SIZE / 4) + const_y_off;
 
-		for(  sint16 x = -2 - ((y + dpy_width) & 1);  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
+		for(  sint16 x = first_column( -2 - ((y + dpy_width) & 1), x_start );  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
 			const int i = ((y + x) >> 1) + i_off;
 			const int j = ((y - x) >> 1) + j_off;
 			const int xpos = x * (IMG_SIZE / 2) + const_x_off;
@@ -582,15 +632,6 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 			}
 		}
 	}
-#ifdef MULTI_THREAD
-	// show thread as paused when finished
-	if(  threaded  ) {
-		pthread_mutex_lock( &hide_mutex );
-		num_threads_paused++;
-		pthread_cond_broadcast( &waiting_cond );
-		pthread_mutex_unlock( &hide_mutex );
-	}
-#endif
 }
 
 
@@ -65,6 +65,12 @@ public:
 	 */
 #ifdef MULTI_THREAD
 	void display_region( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool force_dirty, bool threaded, const sint8 clip_num );
+
+	/**
+	 * Draws the stripes of the screen prepared by display() until all are taken by this or other threads.
+	 * @param clip_num Number of the drawing thread.
+	 */
+	void display_queued_regions( const sint8 clip_num );
 #else
 	void display_region( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool force_dirty );
 #endif
@@ -455,6 +455,7 @@ grund_t::grund_t(koord3d pos)
 	flags = 0;
 	set_image(IMG_EMPTY);    // set   flags = dirty;
 	back_imageid = 0;
+	transitions = TRANSITIONS_UNKNOWN;
 }
 
 
@@ -493,6 +494,7 @@ void grund_t::rotate90()
 {
 	pos.rotate90( welt->get_size().y-1 );
 	slope = slope_t::rotate90( slope );
+	transitions = TRANSITIONS_UNKNOWN;
 	// then rotate the things on this tile
 	if (obj_count() == 254) {
 		dbg->warning("grund_t::rotate90()", "Too many stuff on (%s)", pos.get_str());
@@ -691,6 +693,14 @@ void grund_t::calc_image()
 	objlist.calc_image();
 	// since bridges may alter images of ways, this order is needed!
 	calc_image_internal( false );
+
+	// the transitions depend on the heights and climates of the neighbours
+	transitions = TRANSITIONS_UNKNOWN;
+	for(  int i = 0;  i < 8;  i++  ) {
+		if(  grund_t *gr = welt->lookup_kartenboden( pos.get_2d() + koord::neighbours[i] )  ) {
+			gr->reset_transitions();
+		}
+	}
 }
 
 
@@ -935,6 +945,59 @@ void grund_t::calc_back_image(const sint8 hgt, const slope_t::type slope_this)
 }
 
 
+uint16 grund_t::calc_transitions() const
+{
+	const koord k = get_pos().get_2d();
+	const planquadrat_t *plan = welt->access( k );
+	const uint8 climate_corners = plan->get_climate_corners();
+
+	// get neighbour corner heights
+	sint8 neighbour_height[8][4];
+	welt->get_neighbour_heights( k, neighbour_height );
+
+	//look up neighbouring climates
+	climate neighbour_climate[8];
+	for(  int i = 0;  i < 8;  i++  ) {
+		koord k_neighbour = k + koord::neighbours[i];
+		if(  !welt->is_within_limits(k_neighbour)  ) {
+			k_neighbour = welt->get_closest_coordinate(k_neighbour);
+		}
+		neighbour_climate[i] = welt->get_climate( k_neighbour );
+	}
+
+	const climate climate0 = plan->get_climate();
+	slope_t::type slope_corner = get_grund_hang();
+	uint16 result = 0;
+
+	// get transition climate - look for each corner in turn
+	for(  int i = 0;  i < 4;  i++  ) {
+		const sint8 corner_height = get_hoehe() + corner_sw(slope_corner);
+
+		climate transition_climate = climate0;
+		climate min_climate = arctic_climate;
+
+		// looks up sw, se, ne, nw for i=0...3
+		// we compare with tile either side (e.g. for sw, w and s) and pick highest one
+		for(  int j = 1;  j < 4;  j++ ) {
+			if(  corner_height == neighbour_height[(i * 2 + j) & 7][(i + j) & 3]) {
+				climate climatej = neighbour_climate[(i * 2 + j) & 7];
+				climatej > transition_climate ? transition_climate = climatej : 0;
+				climatej < min_climate ? min_climate = climatej : 0;
+			}
+		}
+
+		if(  min_climate == water_climate  ) {
+			result |= 1 << (12 + i);
+		}
+		if(  ((climate_corners >> i) & 1)  &&  transition_climate > climate0  ) {
+			result |= transition_climate << (i * 3);
+		}
+		slope_corner /= slope_t::southeast;
+	}
+	return result;
+}
+
+
 #ifdef MULTI_THREAD
 void grund_t::display_boden(const sint16 xpos, const sint16 ypos, const sint16 raster_tile_width, const sint8 clip_num, const bool force_show_grid ) const
 #else
@@ -1031,80 +1094,33 @@ void grund_t::display_boden(const sint16 xpos, const sint16 ypos, const sint16 r
 				//display climate transitions - only needed if below snowline (snow_transition>0)
 				//need to process whole tile for all heights anyway as water transitions are needed for all heights
 				const planquadrat_t * plan = welt->access( k );
-				uint8 climate_corners = plan->get_climate_corners();
 				const sint8 snow_transition = welt->get_snowline() - pos.z;
 				weg_t *weg = get_weg(road_wt);
-				if(  climate_corners != 0  &&  (!weg  ||  !weg->hat_gehweg())  ) {
-					uint8 water_corners = 0;
-
-					// get neighbour corner heights
-					sint8 neighbour_height[8][4];
-					welt->get_neighbour_heights( k, neighbour_height );
-
-					//look up neighbouring climates
-					climate neighbour_climate[8];
-					for(  int i = 0;  i < 8;  i++  ) {
-						koord k_neighbour = k + koord::neighbours[i];
-						if(  !welt->is_within_limits(k_neighbour)  ) {
-							k_neighbour = welt->get_closest_coordinate(k_neighbour);
-						}
-						neighbour_climate[i] = welt->get_climate( k_neighbour );
+				if(  plan->get_climate_corners() != 0  &&  (!weg  ||  !weg->hat_gehweg())  ) {
+					if(  transitions == TRANSITIONS_UNKNOWN  ) {
+						transitions = calc_transitions();
 					}
-
-					climate climate0 = plan->get_climate();
-					slope_t::type slope_corner = get_grund_hang();
-
-					// get transition climate - look for each corner in turn
-					for(  int i = 0;  i < 4;  i++  ) {
-						sint8 corner_height = get_hoehe() + corner_sw(slope_corner);
-
-						climate transition_climate = climate0;
-						climate min_climate = arctic_climate;
-
-						for(  int j = 1;  j < 4;  j++ ) {
-							if(  corner_height == neighbour_height[(i * 2 + j) & 7][(i + j) & 3]) {
-								climate climatej = neighbour_climate[(i * 2 + j) & 7];
-								climatej > transition_climate ? transition_climate = climatej : 0;
-								climatej < min_climate ? min_climate = climatej : 0;
-							}
-						}
-
-						if(  min_climate == water_climate  ) {
-							water_corners += 1 << i;
-						}
-						if(  (climate_corners >> i) & 1  &&  !is_water()  &&  snow_transition > 0  ) {
-							// looks up sw, se, ne, nw for i=0...3
-							// we compare with tile either side (e.g. for sw, w and s) and pick highest one
-							if(  transition_climate > climate0  ) {
-								uint8 overlay_corners = 1 << i;
-								slope_t::type slope_corner_se = slope_corner;
-								for(  int j = i + 1;  j < 4;  j++  ) {
-									slope_corner_se /= slope_t::southeast;
-
-									// now we check to see if any of remaining corners have same climate transition (also using highest of course)
-									// if so we combine into this overlay layer
-									if(  (climate_corners >> j) & 1  ) {
-										climate compare = climate0;
-										for(  int k = 1;  k < 4;  k++  ) {
-											corner_height = get_hoehe() + corner_sw(slope_corner_se);
-											if(  corner_height == neighbour_height[(j * 2 + k) & 7][(j + k) & 3]) {
-												climate climatej = neighbour_climate[(j * 2 + k) & 7];
-												climatej > compare ? compare = climatej : 0;
-											}
-										}
-
-										if(  transition_climate == compare  ) {
-											overlay_corners += 1 << j;
-											climate_corners -= 1 << j;
-										}
+					const uint16 corner_climates = transitions;
+
+					if(  !is_water()  &&  snow_transition > 0  ) {
+						// overlay transition climates, all corners with the same climate at once
+						uint8 done_corners = 0;
+						for(  int i = 0;  i < 4;  i++  ) {
+							const climate transition_climate = (climate)((corner_climates >> (i * 3)) & 7);
+							if(  transition_climate != 0  &&  ((done_corners >> i) & 1) == 0  ) {
+								uint8 overlay_corners = 0;
+								for(  int j = i;  j < 4;  j++  ) {
+									if(  ((corner_climates >> (j * 3)) & 7) == transition_climate  ) {
+										overlay_corners |= 1 << j;
 									}
 								}
-								// overlay transition climates
+								done_corners |= overlay_corners;
 								gfx->draw_alpha( ground_desc_t::get_climate_tile( transition_climate, slope ), ground_desc_t::get_alpha_tile( slope, overlay_corners ), ALPHA_GREEN | ALPHA_BLUE, xpos, ypos, 0, 0, true, dirty CLIP_NUM_PAR );
 							}
 						}
-						slope_corner /= slope_t::southeast;
 					}
+
+					const uint8 water_corners = corner_climates >> 12;
 					// finally overlay any water transition
 					if(  water_corners  ) {
 						if(  slope  ) {
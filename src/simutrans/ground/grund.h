@@ -210,6 +210,13 @@ protected:
 	 */
 	uint8 flags;
 
+	/**
+	 * Climate and water transitions drawn over the ground image, derived from
+	 * the neighbours by calc_transitions(). Reset by calc_image() of this tile
+	 * or of a neighbour. TRANSITIONS_UNKNOWN if not yet calculated.
+	 */
+	mutable uint16 transitions;
+
 
 public:
 	/**
@@ -307,6 +314,9 @@ public:
 	 */
 	void calc_image();
 
+	/// Transitions must be recalculated before the next display_boden()
+	void reset_transitions() { transitions = TRANSITIONS_UNKNOWN; }
+
 	/**
 	* Return the number of images the ground has.
 	* @return The number of images.
@@ -510,6 +520,16 @@ public:
 	 */
 	slope_t::type get_disp_way_slope() const;
 
+private:
+	static const uint16 TRANSITIONS_UNKNOWN = 0xFFFF;
+
+	/**
+	 * Bits 0..11 hold the climate overlaid on each corner (3 bits per corner,
+	 * 0 for none), bits 12..15 the corners with a water transition.
+	 */
+	uint16 calc_transitions() const;
+
+public:
 	/**
 	 * Displays the ground images (including foundations, fences and ways)
 	 */
@@ -185,6 +185,11 @@ gui_settings_t::gui_settings_t()
 	simloops_value_label.buf().printf(" 999.9");
 	simloops_value_label.update();
 	add_component( &simloops_value_label, 2 );
+	// Image cache label
+	new_component<gui_label_t>("Image cache:");
+	image_cache_value_label.buf().printf(" 9999 MB 100%%");
+	image_cache_value_label.update();
+	add_component( &image_cache_value_label, 2 );
 }
 
 void gui_settings_t::draw(scr_coord offset)
@@ -221,6 +226,18 @@ void gui_settings_t::draw(scr_coord offset)
 	simloops_value_label.buf().printf(" %d%c%d", loops/10, get_fraction_sep(), loops%10 );
 	simloops_value_label.update();
 
+	// image_cache_label: memory used and hits in the last frame
+	image_cache_stats_t stats;
+	gfx->get_image_cache_stats( stats );
+	const uint32 lookups = stats.hits + stats.misses;
+	color = SYSCOL_TEXT_HIGHLIGHT;
+	if(  stats.budget > 0  &&  stats.size > stats.budget  ) {
+		color = gfx->palette_lookup(COL_YELLOW);
+	}
+	image_cache_value_label.set_color(color);
+	image_cache_value_label.buf().printf(" %u MB %u%%", (uint32)(stats.size >> 20), lookups ? (stats.hits * 100) / lookups : 100 );
+	image_cache_value_label.update();
+
 	// All components are updated, now draw them...
 	gui_aligned_container_t::draw(offset);
 }
@@ -33,7 +33,8 @@ private:
 		frame_time_value_label,
 		idle_time_value_label,
 		fps_value_label,
-		simloops_value_label;
+		simloops_value_label,
+		image_cache_value_label;
 
 public:
 	button_t toolbar_pos, reselect_closes_tool, single_toolbar, stack_toolbars, fullscreen, borderless;
@@ -26,6 +26,7 @@
 #include "../dataobj/powernet.h"
 #include "../dataobj/ribi.h"
 #include "../dataobj/loadsave.h"
+#include "../dataobj/environment.h"
 
 #include "../obj/way/schiene.h"
 #include "../obj/leitung2.h"
@@ -39,7 +40,13 @@
 #include "../tpl/inthashtable_tpl.h"
 #include "../tpl/slist_tpl.h"
 
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+#endif
+
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 sint32 minimap_t::max_cargo=0;
 sint32 minimap_t::max_passed=0;
@@ -606,15 +613,23 @@ PIXVAL minimap_t::calc_severity_color_log(sint32 amount, sint32 max_value)
 }
 
 
-void minimap_t::set_map_color_clip( sint16 x, sint16 y, PIXVAL color )
+void minimap_t::set_map_color_clip( sint16 x, sint16 y, PIXVAL color, const scr_rect &clip )
 {
-	if(  0<=x  &&  (uint16)x < map_data->get_width()  &&  0<=y  &&  (uint16)y < map_data->get_height()  ) {
+	if(  clip.x<=x  &&  x < clip.get_right()  &&  clip.y<=y  &&  y < clip.get_bottom()  ) {
 		map_data->at( x, y ) = color;
 	}
 }
 
 
-void minimap_t::set_map_color(koord k_, const PIXVAL color)
+void minimap_t::set_map_color(koord k, const PIXVAL color)
+{
+	if(  map_data  ) {
+		set_map_color( k, color, scr_rect( 0, 0, map_data->get_width(), map_data->get_height() ) );
+	}
+}
+
+
+void minimap_t::set_map_color(koord k_, const PIXVAL color, const scr_rect &clip)
 {
 	// if map is in normal mode, set new color for map
 	// otherwise do nothing
@@ -633,15 +648,15 @@ void minimap_t::set_map_color(koord k_, const PIXVAL color)
 		const scr_coord_val mid_y = ((xw+1) / 5) + (xw / 18);
 		// center line
 		for(  int x=0;  x<xw;  x++  ) {
-			set_map_color_clip( c.x+x, c.y+mid_y, color );
+			set_map_color_clip( c.x+x, c.y+mid_y, color, clip );
 		}
 		// lines above and below
 		if(  mid_y > 0  ) {
 			scr_coord_val left = 2, right = xw-2 + ((xw>>1)&1);
 			for(  scr_coord_val y_offset = 1;  y_offset <= mid_y;  y_offset++  ) {
 				for(  int x=left;  x<right;  x++  ) {
-					set_map_color_clip( c.x+x, c.y+mid_y+y_offset, color );
-					set_map_color_clip( c.x+x, c.y+mid_y-y_offset, color );
+					set_map_color_clip( c.x+x, c.y+mid_y+y_offset, color, clip );
+					set_map_color_clip( c.x+x, c.y+mid_y-y_offset, color, clip );
 				}
 				left += 2;
 				right -= 2;
@@ -649,8 +664,8 @@ void minimap_t::set_map_color(koord k_, const PIXVAL color)
 		}
 	}
 	else {
-		for(  sint32 x = max(0,c.x);  x < zoom_in+c.x  &&  (uint32)x < map_data->get_width();  x++  ) {
-			for(  sint32 y = max(0,c.y);  y < zoom_in+c.y  &&  (uint32)y < map_data->get_height();  y++  ) {
+		for(  sint32 x = max(clip.x,c.x);  x < zoom_in+c.x  &&  x < clip.get_right();  x++  ) {
+			for(  sint32 y = max(clip.y,c.y);  y < zoom_in+c.y  &&  y < clip.get_bottom();  y++  ) {
 				map_data->at(x, y) = color;
 			}
 		}
@@ -787,7 +802,7 @@ PIXVAL minimap_t::calc_ground_color(const grund_t *gr)
 }
 
 
-bool minimap_t::calc_map_pixel(const grund_t *gr)
+bool minimap_t::calc_map_pixel(const grund_t *gr, const scr_rect &clip)
 {
 	if (!gr) {
 		return false;
@@ -796,7 +811,7 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 	const koord k = gr->get_pos().get_2d();
 
 	if(mode != MAP_PAX_DEST  &&  gr->get_convoi_vehicle()) {
-		set_map_color(k, COL_VEHICLE);
+		set_map_color(k, COL_VEHICLE, clip);
 		return true;
 	}
 
@@ -829,7 +844,7 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 					if (cargo > max_cargo) {
 						max_cargo = cargo;
 					}
-					set_map_color(k, calc_severity_color_log(cargo, max_cargo));
+					set_map_color(k, calc_severity_color_log(cargo, max_cargo), clip);
 					return true;
 				}
 			}
@@ -856,7 +871,7 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 					if (passed > max_passed) {
 						max_passed = passed;
 					}
-					set_map_color(k, calc_severity_color_log(passed, max_passed));
+					set_map_color(k, calc_severity_color_log(passed, max_passed), clip);
 					return true;
 				}
 			}
@@ -869,15 +884,15 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 				const schiene_t* sch = (const schiene_t*)(gr->get_weg(track_wt));
 				// show signals
 				if (sch->has_sign() || sch->has_signal()) {
-					set_map_color(k, gfx->palette_lookup(COL_YELLOW));
+					set_map_color(k, gfx->palette_lookup(COL_YELLOW), clip);
 					return true;
 				}
 				else if (sch->is_electrified()) {
-					set_map_color(k, gfx->palette_lookup(COL_RED));
+					set_map_color(k, gfx->palette_lookup(COL_RED), clip);
 					return true;
 				}
 				else {
-					set_map_color(k, gfx->palette_lookup(COL_WHITE));
+					set_map_color(k, gfx->palette_lookup(COL_WHITE), clip);
 					return true;
 				}
 
@@ -887,7 +902,7 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 		// show max speed (if there)
 		case MAX_SPEEDLIMIT:
 			if (gr->get_max_speed()) {
-				set_map_color(k, calc_severity_color(gr->get_max_speed(), 450));
+				set_map_color(k, calc_severity_color(gr->get_max_speed(), 450), clip);
 				return true;
 			}
 			break;
@@ -897,14 +912,14 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 			if (const leitung_t* lt = gr->find<leitung_t>()) {
 				const sint32 saturated_demand = std::min<uint64>(lt->get_net()->get_demand(), INT32_MAX);
 				const sint32 saturated_supply = std::min<uint64>(lt->get_net()->get_supply(), INT32_MAX);
-				set_map_color(k, calc_severity_color(saturated_demand, saturated_supply));
+				set_map_color(k, calc_severity_color(saturated_demand, saturated_supply), clip);
 				return true;
 			}
 			break;
 
 		case MAP_FOREST:
 			if (gr->obj_count() > 1 && gr->obj_bei(gr->obj_count() - 1)->get_typ() == obj_t::baum) {
-				set_map_color(k, gfx->palette_lookup(COL_GREEN));
+				set_map_color(k, gfx->palette_lookup(COL_GREEN), clip);
 				return true;
 			}
 			break;
@@ -913,16 +928,16 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 		// show ownership
 		if (gr->is_halt()) {
 			// needs fixing!!!
-			set_map_color(k, gfx->palette_lookup(gr->get_halt()->get_player_color() + 3));
+			set_map_color(k, gfx->palette_lookup(gr->get_halt()->get_player_color() + 3), clip);
 			return true;
 		}
 		else if (weg_t* weg = gr->get_weg_nr(0)) {
-			set_map_color(k, weg->get_owner() == NULL ? gfx->palette_lookup(COL_ORANGE) : gfx->palette_lookup(weg->get_owner()->get_player_color1() + 3));
+			set_map_color(k, weg->get_owner() == NULL ? gfx->palette_lookup(COL_ORANGE) : gfx->palette_lookup(weg->get_owner()->get_player_color1() + 3), clip);
 			return true;
 		}
 		if (gebaeude_t* gb = gr->find<gebaeude_t>()) {
 			if (gb->get_owner() != NULL) {
-				set_map_color(k, gfx->palette_lookup(gb->get_owner()->get_player_color1() + 3));
+				set_map_color(k, gfx->palette_lookup(gb->get_owner()->get_player_color1() + 3), clip);
 				return true;
 			}
 		}
@@ -942,7 +957,7 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 					if (level > max_building_level) {
 						max_building_level = level;
 					}
-					set_map_color(k, calc_severity_color(level, max_building_level));
+					set_map_color(k, calc_severity_color(level, max_building_level), clip);
 					return true;
 				}
 			}
@@ -958,6 +973,14 @@ bool minimap_t::calc_map_pixel(const grund_t *gr)
 
 
 void minimap_t::calc_map_pixel(const koord k)
+{
+	if(  map_data  ) {
+		calc_map_pixel( k, scr_rect( 0, 0, map_data->get_width(), map_data->get_height() ) );
+	}
+}
+
+
+void minimap_t::calc_map_pixel(const koord k, const scr_rect &clip)
 {
 	// no pixels visible, so noting to calculate
 	if(!is_visible) {
@@ -978,7 +1001,7 @@ void minimap_t::calc_map_pixel(const koord k)
 				halthandle_t halt = plan->get_haltlist()[i];
 				if (halt->get_pax_enabled() && !halt->get_pax_connections().empty()) {
 					// need fixing!!!
-					set_map_color(k, gfx->palette_lookup(halt->get_player_color() + 3));
+					set_map_color(k, gfx->palette_lookup(halt->get_player_color() + 3), clip);
 					return;
 				}
 			}
@@ -991,7 +1014,7 @@ void minimap_t::calc_map_pixel(const koord k)
 				halthandle_t halt = plan->get_haltlist()[i];
 				if (halt->get_mail_enabled() && !halt->get_mail_connections().empty()) {
 					// need fixing!!!
-					set_map_color(k, gfx->palette_lookup(halt->get_player_color() + 3));
+					set_map_color(k, gfx->palette_lookup(halt->get_player_color() + 3), clip);
 					return;
 				}
 			}
@@ -1003,23 +1026,23 @@ void minimap_t::calc_map_pixel(const koord k)
 		for (uint8 i = 1; i < plan->get_boden_count(); i++) {
 			const grund_t* gr = plan->get_boden_bei(i);
 			if (gr->get_typ()==grund_t::tunnelboden) {
-				if (calc_map_pixel(gr)) {
+				if (calc_map_pixel(gr, clip)) {
 					return;
 				}
 				last_tunnel = gr;
 			}
 		}
 		if(last_tunnel) {
-			set_map_color(k, calc_ground_color(last_tunnel));
+			set_map_color(k, calc_ground_color(last_tunnel), clip);
 		}
 		else {
-			set_map_color(k, gfx->palette_lookup(COL_BLACK));
+			set_map_color(k, gfx->palette_lookup(COL_BLACK), clip);
 		}
 	}
 	else if(grund_t::underground_mode == grund_t::ugm_level) {
 		for (uint8 i = 0; i < plan->get_boden_count(); i++) {
 			const grund_t* gr = plan->get_boden_bei(i);
-			if ((gr->get_hoehe() == grund_t::underground_level  ||  (i==0  && gr->get_hoehe() == grund_t::underground_level))  &&  calc_map_pixel(gr)) {
+			if ((gr->get_hoehe() == grund_t::underground_level  ||  (i==0  && gr->get_hoehe() == grund_t::underground_level))  &&  calc_map_pixel(gr, clip)) {
 				return;
 			}
 		}
@@ -1028,21 +1051,21 @@ void minimap_t::calc_map_pixel(const koord k)
 			gr = plan->get_kartenboden();
 		}
 		if (gr->get_hoehe() <= grund_t::underground_level) {
-			set_map_color(k, calc_ground_color(gr));
+			set_map_color(k, calc_ground_color(gr), clip);
 		}
 		else {
-			set_map_color(k, gfx->palette_lookup(COL_BLACK));
+			set_map_color(k, gfx->palette_lookup(COL_BLACK), clip);
 		}
 	}
 	else {
 		for (uint8 i = 0; i < plan->get_boden_count(); i++) {
 			const grund_t* gr = plan->get_boden_bei(i);
-			if (calc_map_pixel(gr)) {
+			if (calc_map_pixel(gr, clip)) {
 				return;
 			}
 		}
 		// Nothing special => calculate ground color based on last index
-		set_map_color(k, calc_ground_color(plan->get_boden_bei(plan->get_boden_count() - 1)));
+		set_map_color(k, calc_ground_color(plan->get_boden_bei(plan->get_boden_count() - 1)), clip);
 	}
 }
 
@@ -1072,6 +1095,141 @@ void minimap_t::calc_map_size()
 }
 
 
+void minimap_t::calc_map_rect(const scr_rect &clip)
+{
+	if(  clip.w<=0  ||  clip.h<=0  ) {
+		return;
+	}
+
+	koord k;
+	if(  !isometric  ) {
+		// same raster as for the whole map, so that the pixels match when scrolling
+		const koord start_off = koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
+		const koord first( max( 0, ((cur_off.x+clip.x)*zoom_out)/zoom_in - start_off.x - zoom_out ), max( 0, ((cur_off.y+clip.y)*zoom_out)/zoom_in - start_off.y - zoom_out ) );
+		const koord last( ((cur_off.x+clip.get_right())*zoom_out)/zoom_in + zoom_out, ((cur_off.y+clip.get_bottom())*zoom_out)/zoom_in + zoom_out );
+		for(  k.y = start_off.y + (first.y/zoom_out)*zoom_out;  k.y<last.y;  k.y+=zoom_out  ) {
+			for(  k.x = start_off.x + (first.x/zoom_out)*zoom_out;  k.x<last.x;  k.x+=zoom_out  ) {
+				calc_map_pixel(k, clip);
+			}
+		}
+	}
+	else {
+		// only the tiles which may reach into clip (with some margin)
+		// screen x grows with u=x-y, screen y with v=x+y
+		const sint32 h = world->get_size().y;
+		const sint32 xw = zoom_out>=2 ? 1 : 2*zoom_in;
+		const sint32 mid_y = ((xw+1) / 5) + (xw / 18);
+		const sint32 x0 = cur_off.x+clip.x-xw-1, x1 = cur_off.x+clip.get_right()+1;
+		const sint32 y0 = cur_off.y+clip.y-2*mid_y-1, y1 = cur_off.y+clip.get_bottom()+1;
+		const sint32 u_min = (x0*zoom_out)/zoom_in - h - 2;
+		const sint32 u_max = (x1*zoom_out)/zoom_in - h + 2;
+		const sint32 v_min = (y0*2*zoom_out)/zoom_in - 2;
+		const sint32 v_max = (y1*2*zoom_out)/zoom_in + 2;
+		for(  k.y=0;  k.y < world->get_size().y;  k.y++  ) {
+			const sint32 x_end = min( min( u_max+k.y, v_max-k.y ), world->get_size().x-1 );
+			for(  k.x = max( max( u_min+k.y, v_min-k.y ), 0 );  k.x <= x_end;  k.x++  ) {
+				calc_map_pixel(k, clip);
+			}
+		}
+	}
+}
+
+
+#ifdef MULTI_THREAD
+struct minimap_rect_param_t
+{
+	minimap_t *map;
+	scr_rect clip;
+};
+
+
+void *minimap_t::calc_map_rect_thread(void *ptr)
+{
+	minimap_rect_param_t *param = (minimap_rect_param_t *)ptr;
+	param->map->calc_map_rect( param->clip );
+	return NULL;
+}
+#endif
+
+
+void minimap_t::calc_map_rect_threaded(const scr_rect &clip)
+{
+#ifdef MULTI_THREAD
+	// these modes update their maximum during drawing and may restart it
+	const sint32 m = mode & ~MAP_MODE_FLAGS;
+	const bool recalcs = m==MAP_FREIGHT  ||  m==MAP_TRAFFIC  ||  m==MAP_LEVEL;
+	const int num_threads = min( env_t::num_threads, clip.w/64 );
+	if(  !recalcs  &&  num_threads > 1  &&  clip.h >= 64  ) {
+		// each thread gets its own columns, so every pixel is written by the same tiles in the same order as before
+		minimap_rect_param_t param[MAX_THREADS];
+		pthread_t thread[MAX_THREADS];
+		bool started[MAX_THREADS];
+		for(  int t=0;  t<num_threads;  t++  ) {
+			const scr_coord_val left = clip.x + (clip.w*t)/num_threads;
+			const scr_coord_val right = clip.x + (clip.w*(t+1))/num_threads;
+			param[t].map = this;
+			param[t].clip = scr_rect( left, clip.y, right-left, clip.h );
+			started[t] = t < num_threads-1  &&  pthread_create( &thread[t], NULL, calc_map_rect_thread, (void *)&param[t] ) == 0;
+			if(  !started[t]  ) {
+				calc_map_rect( param[t].clip );
+			}
+		}
+		for(  int t=0;  t<num_threads;  t++  ) {
+			if(  started[t]  ) {
+				pthread_join( thread[t], NULL );
+			}
+		}
+		return;
+	}
+#endif
+	calc_map_rect( clip );
+}
+
+
+void minimap_t::scroll_map()
+{
+	const scr_coord delta = new_off - cur_off;
+	const sint32 w = map_data ? map_data->get_width() : 0;
+	const sint32 h = map_data ? map_data->get_height() : 0;
+	if(  map_data==NULL  ||  w!=min( get_size().w, new_size.w )  ||  h!=min( get_size().h, new_size.h )  ||  abs(delta.x)>=w  ||  abs(delta.y)>=h  ) {
+		calc_map();
+		return;
+	}
+
+	// keep the still visible part
+	const sint32 keep_w = w-abs(delta.x);
+	const sint32 src_x = max( 0, delta.x ), dst_x = max( 0, -delta.x );
+	if(  delta.y >= 0  ) {
+		for(  sint32 y=0;  y+delta.y<h;  y++  ) {
+			memmove( &map_data->at(dst_x, y), &map_data->at(src_x, y+delta.y), keep_w*sizeof(PIXVAL) );
+		}
+	}
+	else {
+		for(  sint32 y=h-1;  y+delta.y>=0;  y--  ) {
+			memmove( &map_data->at(dst_x, y), &map_data->at(src_x, y+delta.y), keep_w*sizeof(PIXVAL) );
+		}
+	}
+	cur_off = new_off;
+
+	// and calculate only the newly exposed stripes
+	const scr_rect rows( 0, delta.y>=0 ? h-delta.y : 0, w, abs(delta.y) );
+	const scr_rect cols( delta.x>=0 ? w-delta.x : 0, delta.y>=0 ? 0 : -delta.y, abs(delta.x), h-abs(delta.y) );
+	const PIXVAL black = gfx->palette_lookup(COL_BLACK);
+	for(  sint32 y=rows.y;  y<rows.get_bottom();  y++  ) {
+		for(  sint32 x=0;  x<w;  x++  ) {
+			map_data->at(x, y) = black;
+		}
+	}
+	for(  sint32 y=cols.y;  y<cols.get_bottom();  y++  ) {
+		for(  sint32 x=cols.x;  x<cols.get_right();  x++  ) {
+			map_data->at(x, y) = black;
+		}
+	}
+	calc_map_rect_threaded( rows );
+	calc_map_rect_threaded( cols );
+}
+
+
 void minimap_t::calc_map()
 {
 	// only use bitmap size like screen size
@@ -1087,28 +1245,10 @@ void minimap_t::calc_map()
 	is_visible = true;
 
 	// redraw the map
-	if(  !isometric  ) {
-		koord k;
-		koord start_off = koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
-		koord end_off = start_off+koord( ( map_data->get_width()*zoom_out)/zoom_in+1, ( map_data->get_height()*zoom_out)/zoom_in+1 );
-		for(  k.y=start_off.y;  k.y<end_off.y;  k.y+=zoom_out  ) {
-			for(  k.x=start_off.x;  k.x<end_off.x;  k.x+=zoom_out  ) {
-				calc_map_pixel(k);
-			}
-		}
-	}
-	else {
-		// always the whole map ...
-		if(isometric) {
-			map_data->init( gfx->palette_lookup(COL_BLACK) );
-		}
-		koord k;
-		for(  k.y=0;  k.y < world->get_size().y;  k.y++  ) {
-			for(  k.x=0;  k.x < world->get_size().x;  k.x++  ) {
-				calc_map_pixel(k);
-			}
-		}
+	if(  isometric  ) {
+		map_data->init( gfx->palette_lookup(COL_BLACK) );
 	}
+	calc_map_rect_threaded( scr_rect( 0, 0, map_data->get_width(), map_data->get_height() ) );
 }
 
 
@@ -1299,10 +1439,14 @@ void minimap_t::draw(scr_coord pos)
 		last_mode = mode;
 	}
 
-	if(  needs_redraw  ||  cur_off!=new_off  ||  cur_size!=new_size  ) {
+	if(  needs_redraw  ||  cur_size!=new_size  ) {
 		calc_map();
 		needs_redraw = false;
 	}
+	else if(  cur_off!=new_off  ) {
+		// only scrolled: most of the map is still valid
+		scroll_map();
+	}
 
 	if( map_data==NULL) {
 		return;
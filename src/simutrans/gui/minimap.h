@@ -78,7 +78,7 @@ private:
 	/// the terrain map
 	array2d_tpl<PIXVAL> *map_data;
 
-	void set_map_color_clip( sint16 x, sint16 y, PIXVAL color );
+	void set_map_color_clip( sint16 x, sint16 y, PIXVAL color, const scr_rect &clip );
 
 	/// all stuff connected with schedule display
 	class line_segment_t
@@ -162,6 +162,23 @@ private:
 	/// nonstatic, if we have someday many maps ...
 	void set_map_color(koord k, PIXVAL color);
 
+	/// sets the color of a tile, but only changes pixels inside @p clip
+	void set_map_color(koord k, PIXVAL color, const scr_rect &clip);
+
+	void calc_map_pixel(const koord k, const scr_rect &clip);
+	bool calc_map_pixel(const grund_t *gr, const scr_rect &clip);
+
+	/// recalculates all pixels of map_data inside @p clip (from all tiles reaching into it)
+	void calc_map_rect(const scr_rect &clip);
+
+	/// as calc_map_rect(), but split in columns over several threads if possible
+	void calc_map_rect_threaded(const scr_rect &clip);
+
+	static void *calc_map_rect_thread(void *ptr);
+
+	/// moves map_data to the new offset and only calculates the newly visible parts
+	void scroll_map();
+
 public:
 	scr_coord map_to_screen_coord(const koord &k) const;
 
@@ -207,10 +224,6 @@ public:
 	/// update color with render mode (but few are ignored ... )
 	void calc_map_pixel(const koord k);
 
-	/// update color with render mode (but for that kind of ground)
-	// true for 
-	bool calc_map_pixel(const grund_t *gr);
-
 	void calc_map();
 
 	/// calculates the current size of the map (but do not change anything else)
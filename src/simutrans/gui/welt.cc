@@ -399,11 +399,14 @@ void welt_gui_t::update_preview(bool load_heightfield)
 
 		const int mx = sets->get_size_x()/map_size.w;
 		const int my = sets->get_size_y()/map_size.h;
+		sint16 *hgt = new sint16[map_size.w];
 		for(  int y=0;  y<map_size.h;  y++  ) {
+			karte_t::perlin_hoehe_line( sets, koord(0,y*my), koord(mx,0), koord::invalid, map_size.w, hgt );
 			for(  int x=0;  x<map_size.w;  x++  ) {
-				map.at(x,y) = minimap_t::calc_height_color(karte_t::perlin_hoehe( sets, koord(x*mx,y*my), koord::invalid ), sets->get_groundwater());
+				map.at(x,y) = minimap_t::calc_height_color(hgt[x], sets->get_groundwater());
 			}
 		}
+		delete [] hgt;
 		sets->heightfield = "";
 	}
 	map_preview.set_map_data(&map);
@@ -38,6 +38,9 @@ protected:
 public:
 	uint32 get_current_index() const { return index; }
 
+	/// when loading: true if everything is read
+	bool is_at_end() const { return index >= max_size; }
+
 	bool is_saving() const { return saving; }
 	bool is_loading() const { return !saving; }
 
@@ -548,12 +548,73 @@ network_command_t* network_get_received_command()
 }
 
 
+/// accept a new connection on a server socket
+static void network_accept_client(SOCKET accept_sock)
+{
+	struct sockaddr_in client_name;
+	socklen_t size = sizeof(client_name);
+	SOCKET s = accept(accept_sock, (struct sockaddr *)&client_name, &size);
+	if(  s!=INVALID_SOCKET  ) {
+#if USE_WINSOCK
+		uint32 ip = ntohl((uint32)client_name.sin_addr.S_un.S_addr);
+#else
+		uint32 ip = ntohl((uint32)client_name.sin_addr.s_addr);
+#endif
+		if (blacklist.contains(net_address_t( ip ))) {
+			// refuse connection
+			network_close_socket(s);
+			return;
+		}
+#ifdef  __BEOS__
+		char name[256];
+		sprintf(name, "%lh", client_name.sin_addr.s_addr );
+#else
+		const char *name = inet_ntoa(client_name.sin_addr);
+#endif
+		dbg->message("check_activity()", "Accepted connection from: %s.",  name);
+		socket_list_t::add_client(s, ip);
+	}
+}
+
+
+/// receive from a client and queue the command, if one is complete
+static void network_receive_client(socket_info_t &client)
+{
+	do {
+		network_command_t *nwc = client.receive_nwc();
+		if (nwc) {
+			received_command_queue.append(nwc);
+			dbg->warning( "network_check_activity()", "received cmd %s (id %d) from socket[%d]", nwc->get_name(), nwc->get_id(), client.socket );
+		}
+		// errors are caught and treated in socket_info_t::receive_nwc
+	} while(  client.has_batched_commands()  );
+}
+
+
 /* do appropriate action for network games:
  * - server: accept connection to a new client
  * - all: receive commands and puts them to the received_command_queue
  */
 network_command_t *network_check_activity(int timeout)
 {
+#ifdef USE_EPOLL
+	vector_tpl<socket_info_t*> ready;
+	socket_list_t::wait_for_sockets(ready, false, timeout);
+
+	// receive from clients first: a client removed on error frees its slot,
+	// which must not be reused by a new connection while we still iterate
+	for(socket_info_t* const i : ready) {
+		if(  i->socket!=INVALID_SOCKET  &&  i->is_active()  &&  i->state!=socket_info_t::server  ) {
+			network_receive_client(*i);
+		}
+	}
+	// accept new connections
+	for(socket_info_t* const i : ready) {
+		if(  i->socket!=INVALID_SOCKET  &&  i->state==socket_info_t::server  ) {
+			network_accept_client(i->socket);
+		}
+	}
+#else
 	fd_set fds;
 	FD_ZERO(&fds);
 
@@ -576,29 +637,7 @@ network_command_t *network_check_activity(int timeout)
 		SOCKET accept_sock = iter_s.get_current();
 
 		if(  accept_sock!=INVALID_SOCKET  ) {
-			struct sockaddr_in client_name;
-			socklen_t size = sizeof(client_name);
-			SOCKET s = accept(accept_sock, (struct sockaddr *)&client_name, &size);
-			if(  s!=INVALID_SOCKET  ) {
-#if USE_WINSOCK
-				uint32 ip = ntohl((uint32)client_name.sin_addr.S_un.S_addr);
-#else
-				uint32 ip = ntohl((uint32)client_name.sin_addr.s_addr);
-#endif
-				if (blacklist.contains(net_address_t( ip ))) {
-					// refuse connection
-					network_close_socket(s);
-					continue;
-				}
-#ifdef  __BEOS__
-				char name[256];
-				sprintf(name, "%lh", client_name.sin_addr.s_addr );
-#else
-				const char *name = inet_ntoa(client_name.sin_addr);
-#endif
-				dbg->message("check_activity()", "Accepted connection from: %s.",  name);
-				socket_list_t::add_client(s, ip);
-			}
+			network_accept_client(accept_sock);
 		}
 	}
 
@@ -609,20 +648,28 @@ network_command_t *network_check_activity(int timeout)
 
 		if (sender != INVALID_SOCKET  &&  socket_list_t::has_client(sender)) {
 			uint32 client_id = socket_list_t::get_client_id(sender);
-			network_command_t *nwc = socket_list_t::get_client(client_id).receive_nwc();
-			if (nwc) {
-				received_command_queue.append(nwc);
-				dbg->warning( "network_check_activity()", "received cmd %s (id %d) from socket[%d]", nwc->get_name(), nwc->get_id(), sender );
-			}
-			// errors are caught and treated in socket_info_t::receive_nwc
+			network_receive_client(socket_list_t::get_client(client_id));
 		}
 	}
+#endif
 	return network_get_received_command();
 }
 
 
 void network_process_send_queues(int timeout)
 {
+#ifdef USE_EPOLL
+	// only sockets with queued packets are waited for
+	vector_tpl<socket_info_t*> ready;
+	socket_list_t::wait_for_sockets(ready, true, timeout);
+
+	for(socket_info_t* const i : ready) {
+		if(  i->socket!=INVALID_SOCKET  &&  i->is_active()  ) {
+			i->process_send_queue();
+			// errors are caught and treated in socket_info_t::process_send_queue
+		}
+	}
+#else
 	fd_set fds;
 	FD_ZERO(&fds);
 
@@ -652,6 +699,7 @@ void network_process_send_queues(int timeout)
 		}
 		action --;
 	}
+#endif
 }
 
 
@@ -759,16 +807,7 @@ bool network_send_data( SOCKET dest, const char *buf, const uint16 size, uint16
 			}
 			else {
 				// try again, test whether sending is possible
-				fd_set fds;
-				FD_ZERO(&fds);
-				FD_SET(dest,&fds);
-
-				struct timeval tv;
-				tv.tv_sec = timeout_ms / 1000;
-				tv.tv_usec = (timeout_ms % 1000) * 1000ul;
-
-				// can we write?
-				if(  select( FD_SETSIZE, NULL, &fds, NULL, &tv )!=1  ) {
+				if(  !network_wait_for_socket( dest, true, timeout_ms )  ) {
 					dbg->warning("network_send_data", "Could not write to socket [%d]", dest);
 					return false;
 				}
@@ -810,16 +849,8 @@ bool network_receive_data( SOCKET sender, void *dest, const uint16 len, uint16 &
 	char *ptr = (char *)dest;
 
 	do {
-		fd_set fds;
-		FD_ZERO(&fds);
-		FD_SET(sender,&fds);
-
-		struct timeval tv;
-		tv.tv_sec = timeout_ms / 1000;
-		tv.tv_usec = (timeout_ms % 1000) * 1000ul;
-
 		// can we read?
-		if(  select( FD_SETSIZE, &fds, NULL, NULL, &tv )!=1  ) {
+		if(  !network_wait_for_socket( sender, false, timeout_ms )  ) {
 			return true;
 		}
 
@@ -854,6 +885,30 @@ bool network_receive_data( SOCKET sender, void *dest, const uint16 len, uint16 &
 }
 
 
+bool network_wait_for_socket( SOCKET sock, bool for_writing, int timeout_ms )
+{
+#if USE_WINSOCK  ||  defined __BEOS__
+	fd_set fds;
+	FD_ZERO(&fds);
+	FD_SET(sock,&fds);
+
+	struct timeval tv;
+	tv.tv_sec = timeout_ms / 1000;
+	tv.tv_usec = (timeout_ms % 1000) * 1000ul;
+
+	return select( FD_SETSIZE, for_writing ? NULL : &fds, for_writing ? &fds : NULL, NULL, &tv )==1;
+#else
+	// poll has no limit on the socket number, unlike FD_SET
+	struct pollfd pfd;
+	pfd.fd = sock;
+	pfd.events = for_writing ? POLLOUT : POLLIN;
+	pfd.revents = 0;
+
+	return poll( &pfd, 1, max( timeout_ms, 0 ) )==1;
+#endif
+}
+
+
 void network_close_socket( SOCKET sock )
 {
 	if(  sock != INVALID_SOCKET  ) {
@@ -13,6 +13,12 @@
 #define USE_WINSOCK 0
 #endif
 
+// linux: wait on the sockets with epoll instead of select,
+// which neither scans all sockets nor is limited to FD_SETSIZE
+#if defined(__linux__)  &&  !defined(USE_EPOLL)
+#define USE_EPOLL 1
+#endif
+
 // windows headers
 #if USE_WINSOCK
 // must be include before all simutrans stuff!
@@ -55,6 +61,9 @@
 // all non-windows
 #	include <fcntl.h>
 #	include <errno.h>
+#	ifndef  __BEOS__
+#		include <poll.h>
+#	endif
 	// to keep compatibility to MS windows
 	typedef int SOCKET;
 #	define INVALID_SOCKET -1
@@ -125,6 +134,13 @@ bool network_send_data( SOCKET dest, const char *buf, const uint16 size, uint16
  */
 bool network_receive_data( SOCKET sender, void *dest, uint16 len, uint16 &received, int timeout_ms );
 
+/**
+ * wait until a single socket can be read from (or written to)
+ * @param timeout_ms time-out in milliseconds
+ * @return true if the socket is ready (or has an error to report)
+ */
+bool network_wait_for_socket( SOCKET sock, bool for_writing, int timeout_ms );
+
 void network_process_send_queues(int timeout);
 
 // true, if I can write on the server connection
@@ -150,6 +150,7 @@ void nwc_service_t::rdwr()
 		case SRVC_ADMIN_MSG:
 		case SRVC_GET_COMPANY_LIST:
 		case SRVC_GET_COMPANY_INFO:
+		case SRVC_SCRIPT_PROFILE:
 			packet->rdwr_str(text);
 			break;
 
@@ -208,6 +209,7 @@ const char *network_command_t::id_to_string(uint16 id)
 	CASE_TO_STRING(NWC_SCENARIO);
 	CASE_TO_STRING(NWC_SCENARIO_RULES);
 	CASE_TO_STRING(NWC_STEP);
+	CASE_TO_STRING(NWC_BATCH);
 	}
 
 	return "<unknown network command>";
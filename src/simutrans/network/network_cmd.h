@@ -39,6 +39,7 @@ enum {
 	NWC_SCENARIO,
 	NWC_SCENARIO_RULES,
 	NWC_STEP,
+	NWC_BATCH,
 	NWC_COUNT
 };
 
@@ -119,6 +120,7 @@ public:
 		SRVC_UNLOCK_COMPANY   = 13,
 		SRVC_REMOVE_COMPANY   = 14,
 		SRVC_LOCK_COMPANY     = 15,
+		SRVC_SCRIPT_PROFILE   = 16,
 		SRVC_MAX
 	};
 
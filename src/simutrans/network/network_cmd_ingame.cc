@@ -472,6 +472,10 @@ void nwc_join_t::rdwr()
 	nwc_nick_t::rdwr();
 	packet->rdwr_long(client_id);
 	packet->rdwr_byte(answer);
+	// older versions neither send nor expect this
+	if(  packet->is_saving()  ||  !packet->is_at_end()  ) {
+		packet->rdwr_byte(frame_modes);
+	}
 }
 
 
@@ -492,6 +496,10 @@ bool nwc_join_t::execute(karte_t *welt)
 
 		// no other joining process active?
 		nwj.answer = socket_list_t::get_client(nwj.client_id).is_active()  &&  pending_join_client == INVALID_SOCKET ? 1 : 0;
+		if(  nwj.answer==1  ) {
+			nwj.frame_modes = frame_modes & NETWORK_FRAME_BATCH;
+			socket_list_t::get_client(nwj.client_id).batch_frames = (nwj.frame_modes & NETWORK_FRAME_BATCH) != 0;
+		}
 		DBG_MESSAGE( "nwc_join_t::execute", "client_id=%i active=%i pending_join_client=%i active=%d", socket_list_t::get_client_id(packet->get_sender()), socket_list_t::get_client(nwj.client_id).is_active(), pending_join_client, nwj.answer );
 		nwj.rdwr();
 		if(  nwj.send( packet->get_sender() )  ) {
@@ -604,6 +612,11 @@ void nwc_game_t::rdwr()
 {
 	network_command_t::rdwr();
 	packet->rdwr_long(len);
+	// older versions neither send nor expect this
+	if(  packet->is_saving() ? has_crc : !packet->is_at_end()  ) {
+		packet->rdwr_long(crc);
+		has_crc = true;
+	}
 
 	if (packet->is_loading() && env_t::server) {
 		packet->failed();
@@ -1520,6 +1533,25 @@ bool nwc_service_t::execute(karte_t *welt)
 			break;
 		}
 
+		case SRVC_SCRIPT_PROFILE: {
+			cbuffer_t buf;
+			if (env_t::script_profile) {
+				script_vm_t::write_all_profiles(&buf);
+			}
+			else {
+				buf.append("Script profiling is off, start the server with -script_profile\n");
+			}
+
+			nwc_service_t nws;
+			nws.flag = flag;
+			nws.text = strdup(buf);
+			if (strlen(nws.text) > MAX_PACKET_LEN - 256) {
+				nws.text[MAX_PACKET_LEN - 256] = 0;
+			}
+			nws.send(packet->get_sender());
+			break;
+		}
+
 		case SRVC_UNLOCK_COMPANY: {
 			if (number >= PLAYER_UNOWNED) {
 				break; // invalid number
@@ -121,7 +121,7 @@ private:
 class nwc_join_t : public nwc_nick_t {
 public:
 	nwc_join_t(const char* nick=NULL)
-	: nwc_nick_t(nick), client_id(0), answer(0) { id = NWC_JOIN; }
+	: nwc_nick_t(nick), client_id(0), answer(0), frame_modes(0) { id = NWC_JOIN; }
 
 	bool execute(karte_t *) OVERRIDE;
 	void rdwr() OVERRIDE;
@@ -129,6 +129,12 @@ public:
 	uint32 client_id;
 	uint8 answer;
 
+	/**
+	 * client: frame modes it understands (NETWORK_FRAME_...)
+	 * server: the ones both sides will use
+	 */
+	uint8 frame_modes;
+
 	/**
 	 * this clients is in the process of joining
 	 */
@@ -177,11 +183,16 @@ private:
  */
 class nwc_game_t : public network_command_t {
 public:
-	nwc_game_t(uint32 len_=0) : network_command_t(NWC_GAME), len(len_) {}
+	nwc_game_t(uint32 len_=0) : network_command_t(NWC_GAME), len(len_), crc(0), has_crc(false) {}
 
 	void rdwr() OVERRIDE;
 
 	uint32 len;
+
+	/// crc32 of the savegame, to verify the transfer
+	uint32 crc;
+	/// false if the server is too old to send crc or could not compute it
+	bool has_crc;
 };
 
 /**
@@ -57,29 +57,23 @@ const char *network_receive_file(const SOCKET src_sock, const char *const save_a
 #endif
 
 		// good place to show a progress bar
-		char rbuf[4096];
+		static char rbuf[65536];
 		sint32 length_read = 0;
 		if (FILE* const f = dr_fopen(save_as, "wb")) {
 			while(length_read < length) {
 				if(  timeout > 0  ) {
-					/** 10s for 4096 bytes:
+					/** 10s for each chunk:
 					 * As long as you are not connected with less than 1200 Baud that should be fine
 					 * otherwise upgrade your acoustic coupler to 56k ...
 					 */
-					fd_set fds;
-					FD_ZERO(&fds);
-					FD_SET(src_sock,&fds);
-					struct timeval tv; // 10 s timeout
-					tv.tv_sec = 10000 / 1000;
-					tv.tv_usec = (10000 % 1000) * 1000ul;
-					// can we read?
-					if(  select( FD_SETSIZE, &fds, NULL, NULL, &tv )!=1  ) {
+					// can we read? (10 s timeout)
+					if(  !network_wait_for_socket( src_sock, false, 10000 )  ) {
 						dbg->warning("network_receive_file", "Timeout during transfer: %s", strerror(errno) );
 						break;
 					}
 				}
 				// ok, now here should be something new to read
-				int i = recv(src_sock, rbuf, length_read + 4096 < length ? 4096 : length - length_read, 0);
+				int i = recv(src_sock, rbuf, min( (sint32)sizeof(rbuf), length - length_read ), 0);
 				if (i > 0) {
 					fwrite(rbuf, 1, i, f);
 					length_read += i;
@@ -110,6 +104,7 @@ const char *network_receive_file(const SOCKET src_sock, const char *const save_a
 
 #include "network_cmd.h"
 #include "network_cmd_ingame.h"
+#include "network_packet.h"
 #include "network_socket_list.h"
 
 #include "../dataobj/loadsave.h"
@@ -118,6 +113,32 @@ const char *network_receive_file(const SOCKET src_sock, const char *const save_a
 #include "../world/simworld.h"
 #include "../utils/simstring.h"
 
+#include <zlib.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#include <signal.h>
+#endif
+
+
+/// crc32 of a whole file, to verify a transfer
+static bool get_file_crc(const char *filename, uint32 &crc)
+{
+	FILE *fp = dr_fopen(filename, "rb");
+	if(  fp == NULL  ) {
+		return false;
+	}
+	static Bytef buf[65536];
+	uLong c = crc32(0L, NULL, 0);
+	while(  size_t n = fread(buf, 1, sizeof(buf), fp)  ) {
+		c = crc32(c, buf, n);
+	}
+	const bool ok = !ferror(fp);
+	fclose(fp);
+	crc = (uint32)c;
+	return ok;
+}
+
 
 // connect to address (cp), receive gameinfo, close
 const char *network_gameinfo(const char *cp, gameinfo_t *gi)
@@ -206,6 +227,7 @@ const char *network_connect(const char *cp, karte_t *world)
 		// want to join
 		{
 			nwc_join_t nwc_join( env_t::nickname.c_str() );
+			nwc_join.frame_modes = NETWORK_FRAME_BATCH;
 			nwc_join.rdwr();
 			if (!nwc_join.send(my_client_socket)) {
 				err = "send of NWC_JOIN failed";
@@ -235,6 +257,8 @@ const char *network_connect(const char *cp, karte_t *world)
 		}
 		// set nickname
 		env_t::nickname = nwj->nickname.c_str();
+		// the server told us how to send
+		socket_list_t::get_client( socket_list_t::get_client_id(my_client_socket) ).batch_frames = (nwj->frame_modes & NETWORK_FRAME_BATCH) != 0;
 
 		network_set_client_id(nwj->client_id);
 		// update map counter
@@ -268,11 +292,17 @@ const char *network_connect(const char *cp, karte_t *world)
 			err = "Protocol error (expected NWC_GAME)";
 			goto end;
 		}
-		int len = ((nwc_game_t*)nwc)->len;
+		const nwc_game_t *nwg = (nwc_game_t*)nwc;
 		// guaranteed individual file name ...
 		char filename[256];
 		sprintf( filename, "client%i-network.sve", network_get_client_id() );
-		err = network_receive_file( my_client_socket, filename, len );
+		err = network_receive_file( my_client_socket, filename, nwg->len );
+		if(  err == NULL  &&  nwg->has_crc  ) {
+			uint32 crc;
+			if(  !get_file_crc(filename, crc)  ||  crc != nwg->crc  ) {
+				err = "Savegame damaged during transfer";
+			}
+		}
 	}
 end:
 	if(err) {
@@ -296,7 +326,6 @@ const char *network_send_file( const SOCKET dst_sock, const char *filename )
 		dbg->warning("network_send_file", "could not open file %s", filename);
 		return "Could not open file";
 	}
-	char buffer[1024];
 
 	// find out length
 	fseek(fp, 0, SEEK_END);
@@ -304,8 +333,9 @@ const char *network_send_file( const SOCKET dst_sock, const char *filename )
 	rewind(fp);
 	uint32 bytes_sent = 0;
 
-	// send size of file
+	// send size and checksum of file, without checksum if it cannot be computed
 	nwc_game_t nwc(length);
+	nwc.has_crc = get_file_crc(filename, nwc.crc);
 	if (dst_sock==INVALID_SOCKET  ||  !nwc.send(dst_sock)) {
 		goto error;
 	}
@@ -314,17 +344,41 @@ const char *network_send_file( const SOCKET dst_sock, const char *filename )
 	if(length>0) {
 		loadingscreen_t ls( translator::translate("Transferring game ..."), length, true, true );
 
+#ifdef __linux__
+		// let the kernel copy from the page cache to the socket directly
+		// sendfile() has no MSG_NOSIGNAL, so SIGPIPE stays ignored
+		signal(SIGPIPE, SIG_IGN);
+		off_t offset = 0;
+		while(  offset < length  ) {
+			const ssize_t sent = sendfile(dst_sock, fileno(fp), &offset, min(length - (long)offset, 1l << 20));
+			if(  sent < 0  &&  errno == EAGAIN  &&  network_wait_for_socket(dst_sock, true, 250)  ) {
+				continue;
+			}
+			if(  sent <= 0  ) {
+				dbg->warning("network_send_file", "sendfile failed at %ld of %ld: %s", (long)offset, length, strerror(errno));
+				socket_list_t::remove_client(dst_sock);
+				goto error;
+			}
+			bytes_sent = (uint32)offset;
+			ls.set_progress( bytes_sent );
+		}
+#else
+		char buffer[65536];
 		while(  !feof(fp)  ) {
 			int bytes_read = (int)fread( buffer, 1, sizeof(buffer), fp );
 			uint16 dummy;
-			if( !network_send_data(dst_sock, buffer, bytes_read, dummy, 250) ) {
-				socket_list_t::remove_client(dst_sock);
-				goto error;
+			for(  int i = 0;  i < bytes_read;  i += 16384  ) {
+				// network_send_data() takes at most 64 kB
+				if( !network_send_data(dst_sock, buffer + i, min(bytes_read - i, 16384), dummy, 250) ) {
+					socket_list_t::remove_client(dst_sock);
+					goto error;
+				}
 			}
 
 			bytes_sent += bytes_read;
 			ls.set_progress( bytes_sent );
 		}
+#endif
 	}
 
 	// ok, new client has savegame
@@ -6,6 +6,14 @@
 #include "../simdebug.h"
 #include "network_packet.h"
 #include "network_socket_list.h"
+#include "network_cmd.h"
+#include "../tpl/slist_tpl.h"
+
+#include <string.h>
+
+#ifndef NETTOOL
+#include <zlib.h>
+#endif
 
 
 void packet_t::rdwr_header()
@@ -60,6 +68,32 @@ packet_t::packet_t(SOCKET sender) : memory_rw_t(buf,MAX_PACKET_LEN,false)
 }
 
 
+packet_t::packet_t(SOCKET sender, const uint8 *data, uint16 len) : memory_rw_t(buf,MAX_PACKET_LEN,false)
+{
+	error = ( len < HEADER_SIZE  ||  len > MAX_PACKET_LEN );
+	ready = !error;
+	version = 0;
+	count = 0;
+	size = 0;
+	id = 0;
+	sock = sender;
+	if(  error  ) {
+		return;
+	}
+
+	memcpy(buf, data, len);
+	count = len;
+	set_max_size(HEADER_SIZE);
+	set_index(0);
+	rdwr_header();
+	if(  size != len  ) {
+		dbg->warning("packet_t::packet_t", "packet from [%d] has wrong size (%d instead of %d)", sock, size, len);
+		error = true;
+	}
+	set_max_size(len);
+}
+
+
 void packet_t::recv()
 {
 	if (error  ||  ready) {
@@ -109,14 +143,7 @@ void packet_t::send(SOCKET s, bool complete)
 	if (has_failed()) {
 		return;
 	}
-	// header written ?
-	if (size == 0) {
-		size = get_current_index();
-		// write header at right place
-		set_index(0);
-		set_max_size(HEADER_SIZE);
-		rdwr_header();
-	}
+	finish_header();
 
 	uint16 sent;
 	const int timeout_ms = complete ? 250 : 0;
@@ -138,7 +165,110 @@ void packet_t::send(SOCKET s, bool complete)
 }
 
 
+void packet_t::finish_header()
+{
+	// header written ?
+	if (size == 0) {
+		size = get_current_index();
+		// write header at right place
+		set_index(0);
+		set_max_size(HEADER_SIZE);
+		rdwr_header();
+	}
+}
+
+
 void packet_t::sent_by_server()
 {
 	sock = socket_list_t::get_socket(0);
 }
+
+
+#ifndef NETTOOL
+/**
+ * body of NWC_BATCH:
+ *  uint8  1 if compressed with zlib, else 0
+ *  uint16 length of the combined packets
+ *  the combined packets (including their headers), possibly compressed
+ */
+#define BATCH_INFO_SIZE (3)
+#define BATCH_MAX_DATA (MAX_PACKET_LEN - HEADER_SIZE - BATCH_INFO_SIZE)
+
+packet_t *packet_t::batch(slist_tpl<packet_t *> &queue)
+{
+	// take as many packets as fit uncompressed, in case compression does not help
+	uint32 n = 0;
+	uint32 raw_len = 0;
+	for(packet_t* const p : queue) {
+		if(  p->is_sending()  ||  p->has_failed()  ||  p->get_id() == NWC_BATCH  ||  raw_len + p->get_current_index() > BATCH_MAX_DATA  ) {
+			break;
+		}
+		raw_len += p->get_current_index();
+		n++;
+	}
+	if(  n < 2  ) {
+		return NULL;
+	}
+
+	uint8 raw[BATCH_MAX_DATA];
+	raw_len = 0;
+	for(  uint32 i = 0;  i < n;  i++  ) {
+		packet_t *p = queue.remove_first();
+		p->finish_header();
+		memcpy(raw + raw_len, p->buf, p->size);
+		raw_len += p->size;
+		delete p;
+	}
+
+	uint8 packed[BATCH_MAX_DATA];
+	uLongf packed_len = sizeof(packed);
+	uint8 compressed = compress2(packed, &packed_len, raw, raw_len, Z_BEST_SPEED) == Z_OK  &&  packed_len < raw_len;
+	uint16 len = raw_len;
+
+	packet_t *frame = new packet_t();
+	frame->set_id(NWC_BATCH);
+	frame->rdwr_byte(compressed);
+	frame->rdwr_short(len);
+	const uint32 body_len = compressed ? packed_len : raw_len;
+	memcpy(frame->buf + frame->get_current_index(), compressed ? packed : raw, body_len);
+	frame->set_index(frame->get_current_index() + body_len);
+	return frame;
+}
+
+
+bool packet_t::unbatch(slist_tpl<packet_t *> &packets)
+{
+	uint8 compressed = 0;
+	uint16 raw_len = 0;
+	rdwr_byte(compressed);
+	rdwr_short(raw_len);
+	if(  has_failed()  ||  raw_len > BATCH_MAX_DATA  ) {
+		return false;
+	}
+
+	const uint8 *data = buf + get_current_index();
+	const uint32 data_len = size - get_current_index();
+	uint8 raw[BATCH_MAX_DATA];
+	if(  compressed  ) {
+		uLongf len = sizeof(raw);
+		if(  uncompress(raw, &len, data, data_len) != Z_OK  ||  len != raw_len  ) {
+			return false;
+		}
+		data = raw;
+	}
+	else if(  data_len != raw_len  ) {
+		return false;
+	}
+
+	for(  uint32 pos = 0;  pos < raw_len;  ) {
+		// the size is the first entry of the header, in intel byte order
+		const uint16 len = pos + 2 <= raw_len ? data[pos] | (data[pos+1] << 8) : 0;
+		if(  len < HEADER_SIZE  ||  pos + len > raw_len  ) {
+			return false;
+		}
+		packets.append( new packet_t(sock, data + pos, len) );
+		pos += len;
+	}
+	return true;
+}
+#endif
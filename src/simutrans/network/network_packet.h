@@ -11,11 +11,19 @@
 #include "memory_rw.h"
 #include "network.h"
 
+template<class T> class slist_tpl;
+
 #define MAX_PACKET_LEN (8192)
 
 // static const do not work on all compilers/architectures
 #define HEADER_SIZE (6) // the network sizes are given ...
 
+/**
+ * frame modes a connection agrees on when joining (see nwc_join_t):
+ * NETWORK_FRAME_BATCH - queued packets are combined into (compressed) NWC_BATCH packets
+ */
+#define NETWORK_FRAME_BATCH (1)
+
 
 class packet_t : public memory_rw_t {
 private:
@@ -41,6 +49,9 @@ private:
 
 	void rdwr_header();
 
+	/// sets size and writes the header, before the first bytes go out
+	void finish_header();
+
 public:
 	/**
 	 * constructor: packet is in saving-mode
@@ -54,6 +65,14 @@ public:
 	 */
 	packet_t(SOCKET s);
 
+	/**
+	 * constructor: packet is in loading-mode and already complete
+	 * @param s socket from where the packet was received
+	 * @param data the packet including its header
+	 * @param len number of bytes in data
+	 */
+	packet_t(SOCKET s, const uint8 *data, uint16 len);
+
 	/**
 	 * start/continue sending
 	 * sets bools ready or error
@@ -73,6 +92,9 @@ public:
 	void failed() { error = true; }
 	bool is_ready() const { return ready; }
 
+	/// true, if sending has started
+	bool is_sending() const { return size != 0; }
+
 	// can we understand the received packet?
 	bool check_version() const { return is_saving() || (version <= NETWORK_VERSION); }
 
@@ -86,5 +108,22 @@ public:
 	 * @see network_send_server
 	 */
 	void sent_by_server();
+
+#ifndef NETTOOL
+	/**
+	 * Combines the packets at the front of @p queue, which are not sent yet,
+	 * into one NWC_BATCH packet. Its body is compressed if this saves space.
+	 * The combined packets are removed from the queue and deleted.
+	 * @return the new packet, or NULL if there are not enough packets to combine
+	 */
+	static packet_t *batch(slist_tpl<packet_t *> &queue);
+
+	/**
+	 * Splits a received NWC_BATCH packet into the combined packets.
+	 * @param[out] packets the combined packets are appended here
+	 * @return false if the packet is broken
+	 */
+	bool unbatch(slist_tpl<packet_t *> &packets);
+#endif
 };
 #endif
@@ -12,6 +12,10 @@
 #include "../dataobj/environment.h"
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 
 bool connection_info_t::operator==(const connection_info_t& other) const
 {
@@ -29,10 +33,17 @@ void socket_info_t::reset()
 {
 	delete packet;
 	packet = NULL;
+	if (!send_queue.empty()) {
+		socket_list_t::watch_send_queue(this, false);
+	}
 	while(!send_queue.empty()) {
 		packet_t *p = send_queue.remove_first();
 		delete p;
 	}
+	while(!batched.empty()) {
+		delete batched.remove_first();
+	}
+	batch_frames = false;
 	if (socket != INVALID_SOCKET) {
 		network_close_socket(socket);
 	}
@@ -49,6 +60,9 @@ network_command_t* socket_info_t::receive_nwc()
 	if (!is_active()) {
 		return NULL;
 	}
+	if (!batched.empty()) {
+		return network_command_t::read_from_packet(batched.remove_first());
+	}
 	if (packet == NULL) {
 		packet = new packet_t(socket);
 	}
@@ -60,6 +74,19 @@ network_command_t* socket_info_t::receive_nwc()
 		socket_list_t::remove_client(socket);
 	}
 	else if (packet->is_ready()) {
+#ifndef NETTOOL
+		if (packet->get_id() == NWC_BATCH) {
+			const bool ok = packet->unbatch(batched);
+			delete packet;
+			packet = NULL;
+			if (!ok) {
+				dbg->warning("socket_info_t::receive_nwc", "broken NWC_BATCH from [%d]", socket);
+				socket_list_t::remove_client(socket);
+				return NULL;
+			}
+			return batched.empty() ? NULL : network_command_t::read_from_packet(batched.remove_first());
+		}
+#endif
 		// create command
 		network_command_t *nwc = network_command_t::read_from_packet(packet);
 		// the network_command takes care of deleting packet
@@ -72,13 +99,21 @@ network_command_t* socket_info_t::receive_nwc()
 
 void socket_info_t::process_send_queue()
 {
+#ifndef NETTOOL
+	if (batch_frames  &&  send_queue.get_count() > 1) {
+		// one packet (and one send) for everything queued since the last call
+		if (packet_t *frame = packet_t::batch(send_queue)) {
+			send_queue.insert(frame);
+		}
+	}
+#endif
 	while(!send_queue.empty()) {
 		packet_t *p = send_queue.front();
 		p->send(socket, false);
 		if (p->has_failed()) {
 			// close this client, clear the send_queue
 			socket_list_t::remove_client(socket);
-			break;
+			return;
 		}
 		else if (p->is_ready()) {
 			// packet complete sent, remove from queue
@@ -90,6 +125,9 @@ void socket_info_t::process_send_queue()
 			break;
 		}
 	}
+	if (send_queue.empty()) {
+		socket_list_t::watch_send_queue(this, false);
+	}
 }
 
 
@@ -97,6 +135,9 @@ void socket_info_t::send_queue_append(packet_t *p)
 {
 	if (p) {
 		if (!p->has_failed()) {
+			if (send_queue.empty()) {
+				socket_list_t::watch_send_queue(this, true);
+			}
 			send_queue.append(p);
 		}
 		else {
@@ -125,6 +166,79 @@ uint32 socket_list_t::playing_clients;
  */
 uint32 socket_list_t::server_sockets;
 
+#ifdef USE_EPOLL
+int socket_list_t::epoll_read = -1;
+int socket_list_t::epoll_write = -1;
+/// number of sockets in epoll_write
+uint32 socket_list_t::writers = 0;
+
+
+void socket_list_t::watch_socket(socket_info_t *info)
+{
+	if (epoll_read == -1) {
+		epoll_read = epoll_create1(EPOLL_CLOEXEC);
+		epoll_write = epoll_create1(EPOLL_CLOEXEC);
+		if (epoll_read == -1  ||  epoll_write == -1) {
+			dbg->fatal("socket_list_t::watch_socket", "epoll_create1 failed: %s", strerror(errno));
+		}
+	}
+	// closing the socket removes it from the epoll sets again
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.ptr = info;
+	if (epoll_ctl(epoll_read, EPOLL_CTL_ADD, info->socket, &ev) != 0) {
+		dbg->warning("socket_list_t::watch_socket", "cannot watch socket[%d]: %s", info->socket, strerror(errno));
+	}
+}
+
+
+void socket_list_t::wait_for_sockets(vector_tpl<socket_info_t*> &ready, bool for_writing, int timeout)
+{
+	ready.clear();
+	if (for_writing  &&  writers == 0) {
+		// nothing to send, nothing to wait for
+		return;
+	}
+	if (epoll_read == -1) {
+		// no socket yet, but callers expect to be delayed like by select()
+		if (timeout > 0) {
+			poll(NULL, 0, timeout);
+		}
+		return;
+	}
+
+	struct epoll_event events[64];
+	int n = epoll_wait(for_writing ? epoll_write : epoll_read, events, lengthof(events), max(timeout, 0));
+	for (int i = 0; i < n; i++) {
+		ready.append( (socket_info_t *)events[i].data.ptr );
+	}
+}
+#endif
+
+
+void socket_list_t::watch_send_queue(socket_info_t *info, bool pending)
+{
+#ifdef USE_EPOLL
+	if (info->socket == INVALID_SOCKET  ||  epoll_write == -1) {
+		return;
+	}
+	struct epoll_event ev;
+	ev.events = EPOLLOUT;
+	ev.data.ptr = info;
+	if (epoll_ctl(epoll_write, pending ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, info->socket, &ev) == 0) {
+		if (pending) {
+			writers++;
+		}
+		else {
+			writers--;
+		}
+	}
+#else
+	(void)info;
+	(void)pending;
+#endif
+}
+
 /**
  * book-keeping for the number of connected / playing clients
  */
@@ -164,6 +278,15 @@ void socket_list_t::reset()
 	connected_clients = 0;
 	playing_clients = 0;
 	server_sockets = 0;
+
+#ifdef USE_EPOLL
+	if (epoll_read != -1) {
+		close(epoll_read);
+		close(epoll_write);
+		epoll_read = epoll_write = -1;
+	}
+	writers = 0;
+#endif
 }
 
 
@@ -196,6 +319,9 @@ void socket_list_t::add_client( SOCKET sock, uint32 ip )
 	list[i]->socket = sock;
 	list[i]->address = net_address_t(ip, 0);
 	change_state( i, socket_info_t::connected );
+#ifdef USE_EPOLL
+	watch_socket(list[i]);
+#endif
 
 	network_set_socket_nodelay( sock );
 }
@@ -221,6 +347,9 @@ void socket_list_t::add_server( SOCKET sock )
 	}
 	list[i]->socket = sock;
 	change_state(i, socket_info_t::server);
+#ifdef USE_EPOLL
+	watch_socket(list[i]);
+#endif
 	if (i==0) {
 #ifndef NETTOOL
 		// set server nickname
@@ -61,14 +61,18 @@ public:
 private:
 	packet_t *packet;
 	slist_tpl<packet_t *> send_queue;
+	/// packets received in a NWC_BATCH, not yet turned into commands
+	slist_tpl<packet_t *> batched;
 
 public:
 	connection_state_t state;
 	SOCKET socket;
 	uint16 player_unlocked;
+	/// both sides agreed on NETWORK_FRAME_BATCH when joining
+	bool batch_frames;
 
 public:
-	socket_info_t() : connection_info_t(), packet(0), send_queue(), state(inactive), socket(INVALID_SOCKET), player_unlocked(0) {}
+	socket_info_t() : connection_info_t(), packet(0), send_queue(), batched(), state(inactive), socket(INVALID_SOCKET), player_unlocked(0), batch_frames(false) {}
 
 	~socket_info_t();
 
@@ -87,6 +91,9 @@ public:
 	 */
 	network_command_t* receive_nwc();
 
+	/// true if receive_nwc() has more commands from a batch
+	bool has_batched_commands() const { return !batched.empty(); }
+
 	/**
 	 *
 	 */
@@ -122,6 +129,16 @@ private:
 	static uint32 playing_clients;
 	static uint32 server_sockets;
 
+#ifdef USE_EPOLL
+	/// all active sockets are watched for reading by epoll_read,
+	/// only those with queued packets for writing by epoll_write
+	static int epoll_read;
+	static int epoll_write;
+	static uint32 writers;
+
+	static void watch_socket(socket_info_t *info);
+#endif
+
 public:
 
 	static uint32 get_server_sockets() { return server_sockets; }
@@ -200,6 +217,21 @@ public:
 	 */
 	static void rdwr(packet_t *p, vector_tpl<socket_info_t*> *writeto=&list);
 
+	/**
+	 * start/stop waiting for @p info becoming writable,
+	 * called when its send queue gets filled/emptied
+	 */
+	static void watch_send_queue(socket_info_t *info, bool pending);
+
+#ifdef USE_EPOLL
+	/**
+	 * wait for sockets with activity
+	 * @param[out] ready sockets that can be read from (or written to, if @p for_writing)
+	 * @param timeout in milliseconds
+	 */
+	static void wait_for_sockets(vector_tpl<socket_info_t*> &ready, bool for_writing, int timeout);
+#endif
+
 private:
 	static void book_state_change(socket_info_t::connection_state_t state, sint8 incr);
 
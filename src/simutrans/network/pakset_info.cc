@@ -10,6 +10,8 @@
 #include "../tpl/vector_tpl.h"
 #include "../utils/cbuffer.h"
 
+#include <algorithm>
+
 stringhashtable_tpl<checksum_t*> pakset_info_t::info;
 checksum_t pakset_info_t::general;
 
@@ -66,11 +68,12 @@ void pakset_info_t::calculate_checksum()
 {
 	general.reset();
 
-	// first sort all the desc's
+	// first sort all the desc's (sorting once is much faster than inserting ordered for large paksets)
 	vector_tpl<entry_t> sorted(info.get_count());
 	for(auto const& i : info) {
-		sorted.insert_ordered(entry_t(i.key, i.value), entry_cmp);
+		sorted.append(entry_t(i.key, i.value));
 	}
+	std::sort(sorted.begin(), sorted.end(), entry_cmp);
 	// now loop
 	for(entry_t const& i : sorted) {
 		i.chk->calc_checksum(&general);
@@ -33,4 +33,7 @@
 #define SCREENSHOT_PATH     "screenshot"
 #define SCREENSHOT_PATH_X    SCREENSHOT_PATH "/"
 
+#define CACHE_PATH     "cache"
+#define CACHE_PATH_X    CACHE_PATH "/"
+
 #endif
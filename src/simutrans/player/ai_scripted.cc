@@ -10,6 +10,14 @@
 #include "../dataobj/translator.h"
 #include "../gui/simwin.h"
 #include "../gui/player_frame.h"
+#include "../network/network.h"
+#include "../network/network_cmd_ingame.h"
+#include "../utils/simrandom.h"
+#include "../world/simworld.h"
+
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+#endif
 
 // scripting
 #include "../script/script.h"
@@ -18,6 +26,50 @@
 
 // TODO ai debug window
 
+
+bool ai_scripted_t::stepping_parallel = false;
+
+#ifdef MULTI_THREAD
+static pthread_mutex_t parallel_mutex;
+static recursive_mutex_maker_t parallel_mutex_maker(parallel_mutex);
+#endif
+
+
+ai_scripted_t::parallel_lock_t::parallel_lock_t() :
+	locked(false)
+{
+#ifdef MULTI_THREAD
+	if(  stepping_parallel  ) {
+		pthread_mutex_lock( &parallel_mutex );
+		locked = true;
+	}
+#endif
+}
+
+
+ai_scripted_t::parallel_lock_t::parallel_lock_t(bool needed) :
+	locked(false)
+{
+#ifdef MULTI_THREAD
+	if(  needed  &&  stepping_parallel  ) {
+		pthread_mutex_lock( &parallel_mutex );
+		locked = true;
+	}
+#else
+	(void)needed;
+#endif
+}
+
+
+ai_scripted_t::parallel_lock_t::~parallel_lock_t()
+{
+#ifdef MULTI_THREAD
+	if(  locked  ) {
+		pthread_mutex_unlock( &parallel_mutex );
+	}
+#endif
+}
+
 ai_scripted_t::ai_scripted_t(uint8 nr) : ai_t(nr)
 {
 	script = NULL;
@@ -28,6 +80,9 @@ ai_scripted_t::~ai_scripted_t()
 {
 	delete script;
 	script = NULL;
+	for(deferred_command_t const& d : deferred_commands) {
+		delete d.nwc;
+	}
 }
 
 const char* ai_scripted_t::init( const char *ai_base, const char *ai_name_)
@@ -144,6 +199,91 @@ void ai_scripted_t::step()
 	}
 }
 
+
+void ai_scripted_t::defer_command(network_world_command_t *nwc, bool to_server)
+{
+	deferred_command_t d;
+	d.nwc = nwc;
+	d.to_server = to_server;
+	deferred_commands.append( d );
+}
+
+
+void ai_scripted_t::send_deferred_commands()
+{
+	for(deferred_command_t const& d : deferred_commands) {
+		if(  d.to_server  ) {
+			network_send_server( d.nwc );
+		}
+		else {
+			welt->command_queue_append( d.nwc );
+		}
+	}
+	deferred_commands.clear();
+}
+
+
+#ifdef MULTI_THREAD
+// every thread steps every stride-th ai
+struct ai_step_param_t {
+	vector_tpl<ai_scripted_t *> *ais;
+	uint32 first;
+	uint32 stride;
+};
+
+
+void *ai_scripted_t::step_thread(void *ptr)
+{
+	ai_step_param_t *param = reinterpret_cast<ai_step_param_t *>(ptr);
+	for(  uint32 i = param->first;  i < param->ais->get_count();  i += param->stride  ) {
+		(*param->ais)[i]->step();
+	}
+	return NULL;
+}
+#endif
+
+
+void ai_scripted_t::step_all(vector_tpl<ai_scripted_t *> &ais)
+{
+#ifdef MULTI_THREAD
+	const uint32 num_threads = min( (uint32)env_t::num_threads, ais.get_count() );
+	if(  env_t::parallel_ai_scripts  &&  num_threads > 1  ) {
+		stepping_parallel = true;
+		set_random_mode( INTERACTIVE_RANDOM ); // do not allow simrand() here!
+
+		ai_step_param_t param[MAX_THREADS];
+		pthread_t thread[MAX_THREADS];
+		bool started[MAX_THREADS];
+		for(  uint32 t = 0;  t < num_threads;  t++  ) {
+			param[t].ais = &ais;
+			param[t].first = t;
+			param[t].stride = num_threads;
+			started[t] = t < num_threads-1  &&  pthread_create( &thread[t], NULL, step_thread, (void *)&param[t] ) == 0;
+			if(  !started[t]  ) {
+				step_thread( &param[t] );
+			}
+		}
+		for(  uint32 t = 0;  t < num_threads;  t++  ) {
+			if(  started[t]  ) {
+				pthread_join( thread[t], NULL );
+			}
+		}
+
+		clear_random_mode( INTERACTIVE_RANDOM );
+		stepping_parallel = false;
+
+		// now the world may change
+		for(ai_scripted_t *ai : ais) {
+			ai->send_deferred_commands();
+		}
+		return;
+	}
+#endif
+	for(ai_scripted_t *ai : ais) {
+		ai->step();
+	}
+}
+
 bool ai_scripted_t::new_month()
 {
 	bool res = ai_t::new_month();
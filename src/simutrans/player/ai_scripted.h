@@ -8,8 +8,10 @@
 
 
 #include "ai.h"
+#include "../tpl/vector_tpl.h"
 #include "../utils/plainstring.h"
 
+class network_world_command_t;
 class script_vm_t;
 
 /// Squirrel Script AI
@@ -32,6 +34,23 @@ class ai_scripted_t : public ai_t
 	/// pointer to virtual machine
 	script_vm_t *script;
 
+	/// tool command to be sent after stepping in parallel
+	struct deferred_command_t {
+		network_world_command_t *nwc;
+		bool to_server;
+	};
+	vector_tpl<deferred_command_t> deferred_commands;
+
+	/// sends the deferred commands in the order they were issued
+	void send_deferred_commands();
+
+	/// true while step_all() runs the scripts in parallel
+	static bool stepping_parallel;
+
+#ifdef MULTI_THREAD
+	static void *step_thread(void *ptr);
+#endif
+
 public:
 	ai_scripted_t(uint8 nr);
 
@@ -56,6 +75,35 @@ public:
 
 	void step() OVERRIDE;
 
+	/**
+	 * Steps all scripted ais. With env_t::parallel_ai_scripts they run in
+	 * worker threads. Meanwhile the world is not changed, tools called by
+	 * the scripts are deferred and sent afterwards in player order.
+	 */
+	static void step_all(vector_tpl<ai_scripted_t *> &ais);
+
+	/// @returns true while step_all() runs the scripts in parallel
+	static bool is_stepping_parallel() { return stepping_parallel; }
+
+	/**
+	 * Called by karte_t::set_tool_api() while stepping in parallel instead of
+	 * sending the command. Takes ownership of @p nwc.
+	 */
+	void defer_command(network_world_command_t *nwc, bool to_server);
+
+	/**
+	 * Serializes calls of scripts into game state that is not private
+	 * to one script while stepping in parallel. Does nothing otherwise.
+	 */
+	struct parallel_lock_t {
+		parallel_lock_t();
+		/// only locks if @p needed
+		explicit parallel_lock_t(bool needed);
+		~parallel_lock_t();
+	private:
+		bool locked;
+	};
+
 	/**
 	 * Called monthly by simworld.cc during simulation
 	 * @returns false if player has to be removed (bankrupt/inactive)
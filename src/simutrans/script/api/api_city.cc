@@ -20,7 +20,7 @@ using namespace script_api;
 
 vector_tpl<sint64> const& get_city_stat(stadt_t* city, bool monthly, sint32 INDEX)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	if (city  &&  0<=INDEX  &&  INDEX<MAX_CITY_HISTORY) {
 		uint16 maxi = monthly ? MAX_CITY_HISTORY_MONTHS :MAX_CITY_HISTORY_YEARS;
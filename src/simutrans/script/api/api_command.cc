@@ -15,6 +15,7 @@
 #include "../api_function.h"
 #include "../../builder/brueckenbauer.h"
 #include "../../ground/grund.h"
+#include "../../player/ai_scripted.h"
 #include "../../tool/simtool.h"
 #include "../../world/simworld.h"
 #include "../../dataobj/environment.h"
@@ -86,10 +87,13 @@ SQInteger param<call_tool_init>::push(HSQUIRRELVM vm, call_tool_init v)
 #endif
 	// check if calling suspendable tools is blocked
 	if (!v.no_block) {
-		if (const char* blocker = env_t::networkmode ? sq_get_suspend_blocker(vm) : NULL) {
+		if (const char* blocker = (env_t::networkmode  ||  ai_scripted_t::is_stepping_parallel()) ? sq_get_suspend_blocker(vm) : NULL) {
 			return sq_raise_error(vm, "Cannot call this tool from within `%s'.", blocker);
 		}
 	}
+	// other scripts may run in parallel
+	ai_scripted_t::parallel_lock_t lock;
+
 	// register this tool call for callback with this id
 	uint32 callback_id = suspended_scripts_t::get_unique_key(tool);
 	tool->callback_id = callback_id;
@@ -247,7 +251,7 @@ SQInteger param<call_tool_work>::push(HSQUIRRELVM vm, call_tool_work v)
 	}
 	// check if calling suspendable tools is blocked
 	if (!v.no_block) {
-		if (const char* blocker = env_t::networkmode ? sq_get_suspend_blocker(vm) : NULL) {
+		if (const char* blocker = (env_t::networkmode  ||  ai_scripted_t::is_stepping_parallel()) ? sq_get_suspend_blocker(vm) : NULL) {
 			return sq_raise_error(vm, "Cannot call this tool from within `%s'.", blocker);
 		}
 	}
@@ -255,6 +259,9 @@ SQInteger param<call_tool_work>::push(HSQUIRRELVM vm, call_tool_work v)
 	bool suspended = false;
 	const char* err = NULL;
 
+	// other scripts may run in parallel
+	ai_scripted_t::parallel_lock_t lock;
+
 	// first click of two_click_tool_t
 	if (v.twoclick) {
 		err = welt->call_work_api(tool, player, v.start, suspended);
@@ -338,7 +345,7 @@ call_tool_work build_station_rotation(player_t* pl, koord3d pos, const building_
 	if (const char* err = is_available(building)) {
 		return call_tool_work(err);
 	}
-	static cbuffer_t buf;
+	static thread_local cbuffer_t buf;
 	buf.clear();
 	if (layout >= 0) {
 		uint8 rotation = welt->get_settings().get_rotation();
@@ -421,9 +428,9 @@ call_tool_work build_bridge_at(player_t* pl, koord3d start, const bridge_desc_t*
 call_tool_work set_slope(player_t* pl, koord3d start, my_slope_t slope)
 {
 	// communicate per default_param
-	static char buf[8];
+	static thread_local char buf[8];
 	sprintf(buf, "%2d", (uint8)slope);
-	static tool_setslope_t tool;
+	static thread_local tool_setslope_t tool;
 	// we do not want our slopes translated to double-height (even for single-height paksets), they are already in the double-height system
 	tool.old_slope_compatibility_mode = false;
 	tool.set_default_param(buf);
@@ -462,7 +469,7 @@ call_tool_work change_climate_at(player_t* pl, koord3d start, int climate)
 		return call_tool_work("Invalid climate number provided");
 	}
 	// communicate per default_param
-	static cbuffer_t param;
+	static thread_local cbuffer_t param;
 	param.clear();
 	param.printf("%d", climate);
 	return call_tool_work(TOOL_SET_CLIMATE | GENERAL_TOOL, param, 0, pl, start, start);
@@ -36,7 +36,7 @@ waytype_t get_convoy_wt(convoi_t const *cnv)
 
 vector_tpl<sint64> const& get_convoy_stat(convoi_t* cnv, sint32 INDEX)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	if (cnv  &&  0<=INDEX  &&  INDEX<convoi_t::MAX_CONVOI_COST) {
 		for(uint16 i = 0; i < MAX_MONTHS; i++) {
@@ -49,7 +49,7 @@ vector_tpl<sint64> const& get_convoy_stat(convoi_t* cnv, sint32 INDEX)
 
 vector_tpl<vehicle_desc_t const*> const& convoi_get_vehicles(convoi_t* cnv)
 {
-	static vector_tpl<vehicle_desc_t const*> v;
+	static thread_local vector_tpl<vehicle_desc_t const*> v;
 	v.clear();
 	if (cnv) {
 		for(uint16 i=0; i<cnv->get_vehicle_count(); i++) {
@@ -63,7 +63,7 @@ SQInteger exp_factory_constructor(HSQUIRRELVM vm)
 
 vector_tpl<sint64> const& get_factory_stat(fabrik_t *fab, sint32 INDEX)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	if (fab  &&  0<=INDEX  &&  INDEX<MAX_FAB_STAT) {
 		for(uint16 i = 0; i < MAX_MONTH; i++) {
@@ -76,7 +76,7 @@ vector_tpl<sint64> const& get_factory_stat(fabrik_t *fab, sint32 INDEX)
 
 vector_tpl<sint64> const& get_factory_production_stat(const ware_production_t *prod_slot, sint32 INDEX)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	if (prod_slot  &&  0<=INDEX  &&  INDEX<MAX_FAB_GOODS_STAT) {
 		for(uint16 i = 0; i < MAX_MONTH; i++) {
@@ -101,10 +101,10 @@ uint32 get_consumption_factor(const factory_supplier_desc_t *desc)
 
 vector_tpl<grund_t*> const& factory_get_tile_list(fabrik_t *fab)
 {
-	static vector_tpl<koord> list;
+	static thread_local vector_tpl<koord> list;
 	fab->get_tile_list(list);
 
-	static vector_tpl<grund_t*> tile_list;
+	static thread_local vector_tpl<grund_t*> tile_list;
 	tile_list.clear();
 	for(koord k : list) {
 		tile_list.append(welt->lookup_kartenboden(k));
@@ -114,7 +114,7 @@ vector_tpl<grund_t*> const& factory_get_tile_list(fabrik_t *fab)
 
 vector_tpl<grund_t*> const& factory_get_fields_list(fabrik_t *fab)
 {
-	static vector_tpl<grund_t*> list;
+	static thread_local vector_tpl<grund_t*> list;
 	fab->get_fields_list(list);
 	return list;
 }
@@ -40,7 +40,7 @@ using namespace script_api;
 
 vector_tpl<sint64> const& get_halt_stat(const haltestelle_t *halt, sint32 INDEX)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	if (halt  &&  0<=INDEX  &&  INDEX<MAX_HALT_COST) {
 		for(uint16 i = 0; i < MAX_MONTHS; i++) {
@@ -149,7 +149,7 @@ SQInteger halt_compare(halthandle_t a, halthandle_t b)
 
 vector_tpl<haltestelle_t::connection_t> const& halt_get_connections(const haltestelle_t *halt, const goods_desc_t* freight)
 {
-	static vector_tpl<haltestelle_t::connection_t> dummy;
+	static thread_local vector_tpl<haltestelle_t::connection_t> dummy;
 	dummy.clear();
 	return freight ? halt->get_connections(freight->get_catg_index()) : dummy;
 }
@@ -6,7 +6,7 @@
 #include <sys/stat.h>
 
 #include "../api_function.h"
-#include "../../../squirrel/sqstdio.h" // for loadfile
+#include "../script_loader.h" // for load_file
 #include "../../../squirrel/sq_extensions.h" // for sq_call_restricted
 
 #include "../../sys/simsys.h"
@@ -37,7 +37,7 @@ SQInteger include_aux(HSQUIRRELVM vm)
 	}
 
 	// load script
-	if (!SQ_SUCCEEDED(sqstd_loadfile(vm, (const char*)buf, true))) {
+	if (!SQ_SUCCEEDED(script_loader_t::load_file(vm, (const char*)buf))) {
 		return sq_raise_error(vm, "Reading / compiling script %s failed", filename);
 	}
 	// call it
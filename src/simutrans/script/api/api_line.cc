@@ -27,7 +27,7 @@ using namespace script_api;
 
 vector_tpl<sint64> const& get_line_stat(simline_t *line, sint32 INDEX)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	if (line  &&  0<=INDEX  &&  INDEX<MAX_LINE_COST) {
 		for(uint16 i = 0; i < MAX_MONTHS; i++) {
@@ -292,7 +292,7 @@ static SQInteger get_way_ribi(HSQUIRRELVM vm)
 template<class D>
 static SQInteger map_obj_to_string(HSQUIRRELVM vm) // parameters: obj
 {
-	static cbuffer_t buf;
+	static thread_local cbuffer_t buf;
 	buf.clear();
 	koord3d pos = script_api::param<koord3d>::get(vm, 1);
 	D* obj = script_api::param<D*>::get(vm, 1);
@@ -402,7 +402,7 @@ static call_tool_init depot_start_convoy(depot_t *depot, player_t *player, convo
 
 static vector_tpl<convoihandle_t> const& depot_get_convoy_list(depot_t *depot)
 {
-	static vector_tpl<convoihandle_t> list;
+	static thread_local vector_tpl<convoihandle_t> list;
 	list.clear();
 	if (depot==NULL) {
 		return list;
@@ -418,7 +418,7 @@ static vector_tpl<convoihandle_t> const& depot_get_convoy_list(depot_t *depot)
 
 static vector_tpl<depot_t*> const& get_depot_list(player_t *player, waytype_t wt)
 {
-	static vector_tpl<depot_t*> list;
+	static thread_local vector_tpl<depot_t*> list;
 	list.clear();
 	// do the conversion of waytype_t to depot-type by linetype
 	simline_t::linetype line_type = simline_t::waytype_to_linetype(wt);
@@ -461,7 +461,7 @@ static bool field_is_deletable(field_t* f)
 
 static vector_tpl<sint64> const& get_way_stat(weg_t* weg, sint32 INDEX)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	if (weg  &&  0<=INDEX  &&  INDEX<WAY_STAT_MAX) {
 		for(uint16 i = 0; i < MAX_WAY_STAT_MONTHS; i++) {
@@ -473,7 +473,7 @@ static vector_tpl<sint64> const& get_way_stat(weg_t* weg, sint32 INDEX)
 
 static vector_tpl<grund_t*> const& get_tile_list( gebaeude_t *gb )
 {
-	static vector_tpl<grund_t*> list;
+	static thread_local vector_tpl<grund_t*> list;
 	gb->get_tile_list( list );
 	return list;
 }
@@ -131,7 +131,7 @@ const vector_tpl<const building_desc_t*>& get_building_list(building_desc_t::bty
 
 const vector_tpl<const building_desc_t*>& get_available_stations(building_desc_t::btype type, waytype_t wt, const goods_desc_t *freight)
 {
-	static vector_tpl<const building_desc_t*> dummy;
+	static thread_local vector_tpl<const building_desc_t*> dummy;
 	dummy.clear();
 
 	switch(type) {
@@ -202,7 +202,7 @@ bool is_coupling_allowed(const vehicle_desc_t *desc1, const vehicle_desc_t *desc
 
 const vector_tpl<const vehicle_desc_t*>& get_predecessors(const vehicle_desc_t *desc)
 {
-	static vector_tpl<const vehicle_desc_t*> dummy;
+	static thread_local vector_tpl<const vehicle_desc_t*> dummy;
 	dummy.clear();
 	for(int i=0; i<desc->get_leader_count(); i++) {
 		if (desc->get_leader(i)) {
@@ -214,7 +214,7 @@ const vector_tpl<const vehicle_desc_t*>& get_predecessors(const vehicle_desc_t *
 
 const vector_tpl<const vehicle_desc_t*>& get_successors(const vehicle_desc_t *desc)
 {
-	static vector_tpl<const vehicle_desc_t*> dummy;
+	static thread_local vector_tpl<const vehicle_desc_t*> dummy;
 	dummy.clear();
 	for(int i=0; i<desc->get_trailer_count(); i++) {
 		if (desc->get_trailer(i)) {
@@ -226,7 +226,7 @@ const vector_tpl<const vehicle_desc_t*>& get_successors(const vehicle_desc_t *de
 
 const vector_tpl<const vehicle_desc_t*>& get_available_vehicles(waytype_t wt)
 {
-	static vector_tpl<const vehicle_desc_t*> dummy;
+	static thread_local vector_tpl<const vehicle_desc_t*> dummy;
 
 	bool use_obsolete = welt->get_settings().get_allow_buying_obsolete_vehicles();
 	uint16 time = welt->get_timeline_year_month();
@@ -273,7 +273,7 @@ sint64 tree_get_price()
 
 const vector_tpl<const way_obj_desc_t*>& get_available_wayobjs(waytype_t wt)
 {
-	static vector_tpl<const way_obj_desc_t*> dummy;
+	static thread_local vector_tpl<const way_obj_desc_t*> dummy;
 
 	uint16 time = welt->get_timeline_year_month();
 
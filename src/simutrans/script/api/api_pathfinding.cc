@@ -12,9 +12,12 @@
 #include "../api_class.h"
 #include "../api_function.h"
 #include "../../builder/brueckenbauer.h"
+#include "../../builder/way_pathfinder.h"
 #include "../../builder/wegbauer.h"
 #include "../../descriptor/bridge_desc.h"
+#include "../../descriptor/tunnel_desc.h"
 #include "../../descriptor/way_desc.h"
+#include "../../ground/grund.h"
 #include "../../tpl/binary_heap_tpl.h"
 #include "../../world/simworld.h"
 
@@ -35,6 +38,7 @@ typedef binary_heap_tpl<heap_node_t> simple_heap_t;
 namespace script_api{
 	declare_specialized_param(heap_node_t, "t|x|y", "simple_heap_x::node_x");
 	declare_specialized_param(simple_heap_t*, "t|x|y", "simple_heap_x");
+	declare_specialized_param(way_pathfinder_t*, "t|x|y", "way_pathfinder_x");
 };
 
 SQInteger heap_constructor(HSQUIRRELVM vm)
@@ -121,6 +125,82 @@ bool way_builder_is_allowed_step(way_builder_t *bob, grund_t *from, grund_t *to)
 }
 
 
+SQInteger way_pathfinder_constructor(HSQUIRRELVM vm) // instance, player
+{
+	player_t *player = get_my_player(vm);
+	if (player == NULL) {
+		player = param<player_t*>::get(vm, 2);
+	}
+	if (player == NULL) {
+		return SQ_ERROR;
+	}
+	attach_instance(vm, 1, new way_pathfinder_t(player));
+	return SQ_OK;
+}
+
+void* script_api::param<way_pathfinder_t*>::tag()
+{
+	return (void*)&way_pathfinder_constructor;
+}
+
+way_pathfinder_t* script_api::param<way_pathfinder_t*>::get(HSQUIRRELVM vm, SQInteger index)
+{
+	return get_attached_instance<way_pathfinder_t>(vm, index, param<way_pathfinder_t*>::tag());
+}
+
+void way_pathfinder_add_start(way_pathfinder_t *pf, grund_t *gr)
+{
+	if (gr) {
+		pf->add_start(gr->get_pos());
+	}
+}
+
+void way_pathfinder_add_target(way_pathfinder_t *pf, grund_t *gr)
+{
+	if (gr) {
+		pf->add_target(gr->get_pos());
+	}
+}
+
+SQInteger way_pathfinder_set_costs(HSQUIRRELVM vm) // instance, table
+{
+	way_pathfinder_t *pf = param<way_pathfinder_t*>::get(vm, 1);
+	if (pf == NULL) {
+		return sq_raise_error(vm, "Not a way_pathfinder_x instance");
+	}
+	// missing entries keep their value
+	way_pathfinder_t::costs_t &c = pf->get_costs();
+	get_slot(vm, "way",      c.way,      2);
+	get_slot(vm, "no_way",   c.no_way,   2);
+	get_slot(vm, "slope",    c.slope,    2);
+	get_slot(vm, "curve",    c.curve,    2);
+	get_slot(vm, "crossing", c.crossing, 2);
+	get_slot(vm, "bridge",   c.bridge,   2);
+	get_slot(vm, "tunnel",   c.tunnel,   2);
+	get_slot(vm, "maximum",  c.maximum,  2);
+	// negative costs would break the search
+	c.way      = max(c.way, 0);
+	c.no_way   = max(c.no_way, 0);
+	c.slope    = max(c.slope, 0);
+	c.curve    = max(c.curve, 0);
+	c.crossing = max(c.crossing, 0);
+	c.bridge   = max(c.bridge, 0);
+	c.tunnel   = max(c.tunnel, 0);
+	return 0;
+}
+
+bool way_pathfinder_search(way_pathfinder_t *pf, uint32 max_nodes)
+{
+	const way_pathfinder_t::state_t state = pf->step(max_nodes);
+	return state != way_pathfinder_t::searching;
+}
+
+bool way_pathfinder_is_found(way_pathfinder_t *pf)
+{
+	return pf->get_state() == way_pathfinder_t::found;
+}
+
+
 koord3d bridge_builder_find_end_pos(player_t *player, koord3d pos, my_ribi_t mribi, const bridge_desc_t *bridge, uint32 min_length)
 {
 	sint8 height;
@@ -204,6 +284,103 @@ void export_pathfinding(HSQUIRRELVM vm)
 
 	end_class(vm);
 
+	/**
+	 * Route search for new ways, which runs in the game and not in the script.
+	 *
+	 * Add start and target tiles, then call @ref search repeatedly until it returns true.
+	 * Each call expands only a limited number of tiles, so a long search can be spread
+	 * over many script steps. Allowed steps, bridges and tunnels are checked with the
+	 * same rules as for the way building tools.
+	 * Changing the way, bridge or tunnel restarts a running search. If the map
+	 * is enlarged or rotated meanwhile, the search fails.
+	 *
+	 * @code
+	 * local pf = way_pathfinder_x(player_x(1))
+	 * pf.set_build_types(way)
+	 * pf.set_bridge(bridge)
+	 * pf.set_costs({ slope = 40, bridge = 30 })
+	 * pf.add_start(tile_x(10, 10, 0))
+	 * pf.add_target(tile_x(100, 40, 0))
+	 * while (!pf.search(1000)) {
+	 *     sleep()
+	 * }
+	 * if (pf.is_found()) {
+	 *     local route = pf.get_route()
+	 * }
+	 * @endcode
+	 */
+	create_class(vm, "way_pathfinder_x", 0);
+	/**
+	 * Constructor
+	 * @param pl player that wants to plan, for ai scripts is set to ai player_x::self
+	 * @typemask way_pathfinder_x(player_x)
+	 */
+	register_function(vm, way_pathfinder_constructor, "constructor", 2, "xx");
+	sq_settypetag(vm, -1, param<way_pathfinder_t*>::tag());
+	/**
+	 * Sets the way to be planned. Needed before the search.
+	 * @param way descriptor of way to be planned
+	 */
+	register_method(vm, &way_pathfinder_t::set_way, "set_build_types");
+	/**
+	 * Sets the bridge to use where the way is blocked, null for no bridges (default).
+	 * @param bridge bridge descriptor
+	 */
+	register_method(vm, &way_pathfinder_t::set_bridge, "set_bridge");
+	/**
+	 * Sets the tunnel to use for going uphill, null for no tunnels (default).
+	 * @param tunnel tunnel descriptor
+	 */
+	register_method(vm, &way_pathfinder_t::set_tunnel, "set_tunnel");
+	/**
+	 * Changes the costs of the search. The table may contain any of these entries,
+	 * the defaults are taken from the way_count_* settings in simuconf.tab:
+	 * - way: step on a tile which already has the way
+	 * - no_way: step on a tile without the way
+	 * - slope: additional cost of a slope
+	 * - curve: additional cost of a change of direction
+	 * - crossing: additional cost of tiles with other ways
+	 * - bridge: per tile of a bridge
+	 * - tunnel: per tile of a tunnel
+	 * - maximum: routes with higher costs are not searched
+	 * @param costs table with new costs
+	 * @typemask void(table)
+	 */
+	register_function(vm, way_pathfinder_set_costs, "set_costs", 2, "xt");
+	/**
+	 * Adds a tile the route may start on. Ends a running search.
+	 * @param tile start tile
+	 */
+	register_method(vm, way_pathfinder_add_start, "add_start", true);
+	/**
+	 * Adds a tile the route may end on. Ends a running search.
+	 * @param tile target tile
+	 */
+	register_method(vm, way_pathfinder_add_target, "add_target", true);
+	/**
+	 * Forgets start and target tiles and the route.
+	 */
+	register_method(vm, &way_pathfinder_t::clear, "clear");
+	/**
+	 * Starts or continues the search.
+	 * @param max_nodes at most so many tiles are examined in this call
+	 * @returns true if the search is finished (then check @ref is_found)
+	 */
+	register_method(vm, way_pathfinder_search, "search", true);
+	/// @returns true if a route was found
+	register_method(vm, way_pathfinder_is_found, "is_found", true);
+	/**
+	 * @returns the route from a start to a target tile. Successive tiles which are
+	 *          not adjacent are the ends of a bridge or tunnel.
+	 */
+	register_method(vm, &way_pathfinder_t::get_route, "get_route");
+	/// @returns the cost of the route
+	register_method(vm, &way_pathfinder_t::get_route_cost, "get_cost");
+	/// @returns number of tiles examined so far
+	register_method(vm, &way_pathfinder_t::get_expanded_count, "get_expanded_count");
+
+	end_class(vm);
+
 	/**
 	 * Class with helper methods for bridge planning.
 	 */
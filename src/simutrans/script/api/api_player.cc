@@ -22,7 +22,7 @@ using namespace script_api;
 
 vector_tpl<sint64> const& get_player_stat(player_t *player, sint32 INDEX, sint32 TTYPE, bool monthly)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	bool atv = false;
 	if (TTYPE<0  ||  TTYPE>=TT_MAX) {
@@ -20,7 +20,8 @@
 
 using namespace script_api;
 
-static char buf[40];
+// one per thread, scripts may run in parallel
+static thread_local char buf[40];
 
 
 static plainstring double_to_string(double f, sint32 decimals)
@@ -11,10 +11,13 @@
 #include "get_next.h"
 #include "../api_class.h"
 #include "../api_function.h"
+#include "../../macros.h"
 #include "../../tool/simmenu.h"
 #include "../../world/simworld.h"
 #include "../../ground/wasser.h"
 #include "../../obj/crossing.h"
+#include "../../obj/way/weg.h"
+#include "../../player/ai_scripted.h"
 
 #include "../../simconvoi.h"
 #include "../../vehicle/vehicle.h"
@@ -100,6 +103,19 @@ bool is_crossing(grund_t *gr)
 	return gr->find<crossing_t>();
 }
 
+// flags share one byte with other bits, other scripts may run in parallel
+void tile_mark(grund_t *gr)
+{
+	ai_scripted_t::parallel_lock_t lock;
+	gr->set_flag(grund_t::marked);
+}
+
+void tile_unmark(grund_t *gr)
+{
+	ai_scripted_t::parallel_lock_t lock;
+	gr->clear_flag(grund_t::marked);
+}
+
 halthandle_t get_first_halt_on_square(planquadrat_t* plan)
 {
 	return plan->get_halt(NULL);
@@ -107,7 +123,7 @@ halthandle_t get_first_halt_on_square(planquadrat_t* plan)
 
 vector_tpl<halthandle_t> const& square_get_halt_list(planquadrat_t *plan)
 {
-	static vector_tpl<halthandle_t> list;
+	static thread_local vector_tpl<halthandle_t> list;
 	list.clear();
 	if (plan) {
 		const halthandle_t* haltlist = plan->get_haltlist();
@@ -120,7 +136,7 @@ vector_tpl<halthandle_t> const& square_get_halt_list(planquadrat_t *plan)
 
 vector_tpl<convoihandle_t> const get_convoy_list(grund_t* gr)
 {
-	static vector_tpl<convoihandle_t> list;
+	static thread_local vector_tpl<convoihandle_t> list;
 	list.clear();
 
 	for( uint8 n = 0; n<gr->obj_count(); n++) {
@@ -135,6 +151,199 @@ vector_tpl<convoihandle_t> const get_convoy_list(grund_t* gr)
 	return list;
 }
 
+
+/// at most so many squares are returned by one area query
+#define MAX_AREA_SQUARES (1<<20)
+
+/// @returns map size in script coordinates
+static koord get_script_map_size()
+{
+	koord size = welt->get_size();
+	if (coordinate_transform_t::get_rotation() & 1) {
+		sim::swap(size.x, size.y);
+	}
+	return size;
+}
+
+
+/**
+ * Reads the corners of an area (parameters 2 and 3) in script coordinates,
+ * from gets the smaller coordinates. The area may reach beyond the map.
+ * @returns false if the area is too large
+ */
+static bool get_area(HSQUIRRELVM vm, koord &from, koord &to)
+{
+	// not param<koord>: we want to go through the squares in script order
+	get_slot(vm, "x", from.x, 2);
+	get_slot(vm, "y", from.y, 2);
+	get_slot(vm, "x", to.x, 3);
+	get_slot(vm, "y", to.y, 3);
+
+	if (from.x > to.x) {
+		sim::swap(from.x, to.x);
+	}
+	if (from.y > to.y) {
+		sim::swap(from.y, to.y);
+	}
+	return (sint64)(to.x - from.x + 1) * (to.y - from.y + 1) <= MAX_AREA_SQUARES;
+}
+
+
+static climate_bits get_climates_param(HSQUIRRELVM vm, SQInteger index)
+{
+	SQInteger climates = ALL_CLIMATES;
+	if (sq_gettop(vm) >= index) {
+		sq_getinteger(vm, index, &climates);
+	}
+	return (climate_bits)(climates & ALL_CLIMATES);
+}
+
+
+/**
+ * Pushes an array with one entry for every square of the area on the map, row by row.
+ * The entry is pushed by @p push_square.
+ */
+static SQInteger push_area_array(HSQUIRRELVM vm, void (*push_square)(HSQUIRRELVM, const grund_t*, climate_bits), climate_bits cl = ALL_CLIMATES)
+{
+	koord from, to;
+	if (!get_area(vm, from, to)) {
+		return sq_raise_error(vm, "Area too large, at most %d squares", MAX_AREA_SQUARES);
+	}
+
+	const koord size = get_script_map_size();
+	sq_newarray(vm, 0);
+	// sint32, since the last square may be at 32767
+	for(sint32 y = from.y; y <= to.y; y++) {
+		for(sint32 x = from.x; x <= to.x; x++) {
+			koord k(x, y);
+			coordinate_transform_t::koord_sq2w(k);
+			// squares off the map keep their index, but are null
+			const grund_t *gr = x >= 0  &&  y >= 0  &&  x < size.x  &&  y < size.y ? welt->lookup_kartenboden(k) : NULL;
+			if (gr) {
+				push_square(vm, gr, cl);
+			}
+			else {
+				sq_pushnull(vm);
+			}
+			sq_arrayappend(vm, -2);
+		}
+	}
+	return 1;
+}
+
+
+static void push_height(HSQUIRRELVM vm, const grund_t *gr, climate_bits)
+{
+	sq_pushinteger(vm, gr->get_hoehe());
+}
+
+
+static void push_slope(HSQUIRRELVM vm, const grund_t *gr, climate_bits)
+{
+	param<my_slope_t>::push(vm, gr->get_grund_hang());
+}
+
+
+static void push_way_types(HSQUIRRELVM vm, const grund_t *gr, climate_bits)
+{
+	uint32 mask = 0;
+	for(uint8 i = 0; i < 2; i++) {
+		if (const weg_t *w = gr->get_weg_nr(i)) {
+			mask |= 1u << w->get_waytype();
+		}
+	}
+	sq_pushinteger(vm, mask);
+}
+
+
+static void push_owner(HSQUIRRELVM vm, const grund_t *gr, climate_bits)
+{
+	sint32 owner = -1;
+	for(uint8 i = 0; i < gr->obj_count()  &&  owner < 0; i++) {
+		if (gr->obj_bei(i)->get_owner_nr() != PLAYER_UNOWNED) {
+			owner = gr->obj_bei(i)->get_owner_nr();
+		}
+	}
+	sq_pushinteger(vm, owner);
+}
+
+
+static void push_buildable(HSQUIRRELVM vm, const grund_t *gr, climate_bits cl)
+{
+	sq_pushbool(vm, welt->square_is_free(gr->get_pos().get_2d(), 1, 1, NULL, cl));
+}
+
+
+static SQInteger area_get_heights(HSQUIRRELVM vm)
+{
+	return push_area_array(vm, push_height);
+}
+
+
+static SQInteger area_get_slopes(HSQUIRRELVM vm)
+{
+	return push_area_array(vm, push_slope);
+}
+
+
+static SQInteger area_get_way_types(HSQUIRRELVM vm)
+{
+	return push_area_array(vm, push_way_types);
+}
+
+
+static SQInteger area_get_owners(HSQUIRRELVM vm)
+{
+	return push_area_array(vm, push_owner);
+}
+
+
+static SQInteger area_get_buildable(HSQUIRRELVM vm)
+{
+	return push_area_array(vm, push_buildable, get_climates_param(vm, 4));
+}
+
+
+static SQInteger area_find_free_places(HSQUIRRELVM vm)
+{
+	koord from, to;
+	if (!get_area(vm, from, to)) {
+		return sq_raise_error(vm, "Area too large, at most %d squares", MAX_AREA_SQUARES);
+	}
+	// size is not a position, do not rotate it
+	koord size;
+	get_slot(vm, "x", size.x, 4);
+	get_slot(vm, "y", size.y, 4);
+	const koord map_size = get_script_map_size();
+	if (size.x < 1  ||  size.y < 1  ||  size.x > map_size.x  ||  size.y > map_size.y) {
+		return sq_raise_error(vm, "Invalid size %d,%d", size.x, size.y);
+	}
+	const climate_bits climates = get_climates_param(vm, 5);
+
+	// only places that fit on the map
+	from.x = max(from.x, 0);
+	from.y = max(from.y, 0);
+	to.x = min(to.x, map_size.x - size.x);
+	to.y = min(to.y, map_size.y - size.y);
+
+	sq_newarray(vm, 0);
+	for(sint32 y = from.y; y <= to.y; y++) {
+		for(sint32 x = from.x; x <= to.x; x++) {
+			// opposite corners in world coordinates, the map may be rotated
+			koord k1(x, y), k2(x + size.x - 1, y + size.y - 1);
+			coordinate_transform_t::koord_sq2w(k1);
+			coordinate_transform_t::koord_sq2w(k2);
+			const koord pos(min(k1.x, k2.x), min(k1.y, k2.y));
+			if (welt->square_is_free(pos, abs(k2.x - k1.x) + 1, abs(k2.y - k1.y) + 1, NULL, climates)) {
+				param<koord>::push(vm, k1);
+				sq_arrayappend(vm, -2);
+			}
+		}
+	}
+	return 1;
+}
+
+
 void export_tiles(HSQUIRRELVM vm)
 {
 	/**
@@ -310,9 +519,9 @@ void export_tiles(HSQUIRRELVM vm)
 	/// Check if tile is marked.
 	register_method_fv(vm, &grund_t::get_flag, "is_marked", freevariable<uint8>(grund_t::marked));
 	/// Unmark tile.
-	register_method_fv(vm, &grund_t::clear_flag, "unmark", freevariable<uint8>(grund_t::marked));
+	register_method(vm, &tile_unmark, "unmark", true);
 	/// Mark tile.
-	register_method_fv(vm, &grund_t::set_flag, "mark", freevariable<uint8>(grund_t::marked));
+	register_method(vm, &tile_mark, "mark", true);
 	//@}
 
 	/**
@@ -415,4 +624,74 @@ void export_tiles(HSQUIRRELVM vm)
 	register_method(vm, &planquadrat_t::get_climate, "get_climate");
 
 	end_class(vm);
+
+	/**
+	 * Queries for all squares of a rectangle at once.
+	 * Much faster than creating square_x or tile_x instances for every square.
+	 *
+	 * The corners @p from and @p to are included. Results are arrays with one
+	 * entry per square, row by row: the entry of square (x, y) has the index
+	 * (y - y0) * w + (x - x0), where (x0, y0) is the corner with the smaller
+	 * coordinates and w the width of the rectangle. Entries of squares outside
+	 * the map are null. The ground tile of each square is checked only.
+	 *
+	 * Usage:
+	 * @code
+	 * local from = coord(10, 20), to = coord(73, 83)
+	 * local heights = area_x.get_heights(from, to)
+	 * local h = heights[ (40 - 20) * 64 + (30 - 10) ] // height at (30, 40)
+	 * @endcode
+	 */
+	create_class(vm, "area_x", 0);
+	/**
+	 * Heights of the ground tiles.
+	 * @param from corner
+	 * @param to corner
+	 * @typemask array<integer>(coord, coord)
+	 */
+	STATIC register_function(vm, area_get_heights, "get_heights", 3, ". t|x|y t|x|y");
+	/**
+	 * Slopes of the ground tiles.
+	 * @param from corner
+	 * @param to corner
+	 * @typemask array<slope>(coord, coord)
+	 */
+	STATIC register_function(vm, area_get_slopes, "get_slopes", 3, ". t|x|y t|x|y");
+	/**
+	 * Way types on the ground tiles as bit masks:
+	 * bit (1 << wt) is set if there is a way of type @p wt.
+	 * @param from corner
+	 * @param to corner
+	 * @typemask array<integer>(coord, coord)
+	 */
+	STATIC register_function(vm, area_get_way_types, "get_way_types", 3, ". t|x|y t|x|y");
+	/**
+	 * Owners of the ground tiles: number of the player owning the first owned
+	 * object (way, building, ...) on the tile, -1 if there is none.
+	 * @param from corner
+	 * @param to corner
+	 * @typemask array<integer>(coord, coord)
+	 */
+	STATIC register_function(vm, area_get_owners, "get_owners", 3, ". t|x|y t|x|y");
+	/**
+	 * Whether a building of size 1x1 could be built on the squares:
+	 * nothing there that cannot be removed, climate allowed.
+	 * @param from corner
+	 * @param to corner
+	 * @param climates allowed climates as bit mask (1 << climate), all climates if omitted
+	 * @typemask array<bool>(coord, coord, integer)
+	 */
+	STATIC register_function(vm, area_get_buildable, "get_buildable", -3, ". t|x|y t|x|y i");
+	/**
+	 * Searches places for a building in the rectangle, with the same rules as for building houses.
+	 * @param from corner
+	 * @param to corner
+	 * @param size size of the building
+	 * @param climates allowed climates as bit mask (1 << climate), all climates if omitted
+	 * @returns array of corners with the smallest coordinates of all free places of the given size, that start within the rectangle
+	 * @typemask array<coord>(coord, coord, coord, integer)
+	 */
+	STATIC register_function(vm, area_find_free_places, "find_free_places", -4, ". t|x|y t|x|y t|x|y i");
+
+	end_class(vm);
 }
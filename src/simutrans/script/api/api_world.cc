@@ -35,7 +35,7 @@ mytime_ticks_t world_get_time(karte_t*)
 
 vector_tpl<sint64> const& get_world_stat(karte_t* welt, bool monthly, sint32 INDEX)
 {
-	static vector_tpl<sint64> v;
+	static thread_local vector_tpl<sint64> v;
 	v.clear();
 	if (0<=INDEX  &&  INDEX<karte_t::MAX_WORLD_COST) {
 		uint16 maxi = monthly ? MAX_WORLD_HISTORY_MONTHS : MAX_WORLD_HISTORY_YEARS;
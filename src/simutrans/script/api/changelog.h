@@ -12,6 +12,8 @@
  * - Added @ref halt_x::set_permissions
  * - Added @ref halt_x::can_use_halt
  * - Added @ref world_x::create_player
+ * - Added @ref way_pathfinder_x
+ * - Added @ref area_x to query heights, slopes, ways, owners and free places of whole rectangles
  *
  * @section api-trunk Current trunk
  *
@@ -411,6 +411,17 @@ BEGIN {
 	export_types_ai["simple_heap_x::insert"] = "void(integer, integer)"
 	export_types_ai["way_planner_x::set_build_types"] = "void(way_desc_x)"
 	export_types_ai["way_planner_x::is_allowed_step"] = "bool(tile_x, tile_x)"
+	export_types_ai["way_pathfinder_x::set_build_types"] = "void(way_desc_x)"
+	export_types_ai["way_pathfinder_x::set_bridge"] = "void(bridge_desc_x)"
+	export_types_ai["way_pathfinder_x::set_tunnel"] = "void(tunnel_desc_x)"
+	export_types_ai["way_pathfinder_x::add_start"] = "void(tile_x)"
+	export_types_ai["way_pathfinder_x::add_target"] = "void(tile_x)"
+	export_types_ai["way_pathfinder_x::clear"] = "void()"
+	export_types_ai["way_pathfinder_x::search"] = "bool(integer)"
+	export_types_ai["way_pathfinder_x::is_found"] = "bool()"
+	export_types_ai["way_pathfinder_x::get_route"] = "array<coord3d>()"
+	export_types_ai["way_pathfinder_x::get_cost"] = "integer()"
+	export_types_ai["way_pathfinder_x::get_expanded_count"] = "integer()"
 	export_types_ai["bridge_planner_x::find_end"] = "coord3d(player_x, coord3d, dir, bridge_desc_x, integer)"
 	export_types_ai["command_x::get_flags"] = "integer()"
 	export_types_ai["command_x::set_flags"] = "void(integer)"
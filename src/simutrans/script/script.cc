@@ -8,12 +8,14 @@
 #include <stdarg.h>
 #include <string.h>
 #include "../../squirrel/sqstdaux.h" // for error handlers
-#include "../../squirrel/sqstdio.h" // for loadfile
+#include "script_loader.h" // for load_file
 #include "../../squirrel/sqstdstring.h" // export for scripts
 #include "../../squirrel/sqstdmath.h" // export for scripts
 #include "../../squirrel/sqstdsystem.h" // export for scripts
 #include "../../squirrel/sq_extensions.h" // for sq_call_restricted
 
+#include "../dataobj/environment.h"
+#include "../sys/simsys.h"
 #include "../utils/log.h"
 
 #include "../tpl/inthashtable_tpl.h"
@@ -21,6 +23,7 @@
 // for error popups
 #include "../gui/help_frame.h"
 #include "../gui/simwin.h"
+#include "../player/ai_scripted.h"
 #include "../utils/cbuffer.h"
 #include "../utils/plainstring.h"
 
@@ -66,8 +69,8 @@ void script_vm_t::errorfunc(HSQUIRRELVM vm, const SQChar *s_, ...)
 	}
 
 	// only one error message at a time - hopefully
-	// collect into static buffer
-	static cbuffer_t buf;
+	// collect into static buffer, one per thread as ais may run in parallel
+	static thread_local cbuffer_t buf;
 	if (strcmp(s, "<error>")==0) {
 		// start of error message
 		buf.clear();
@@ -75,6 +78,7 @@ void script_vm_t::errorfunc(HSQUIRRELVM vm, const SQChar *s_, ...)
 	}
 	else if (strcmp(s, "</error>")==0) {
 		// end of error message
+		ai_scripted_t::parallel_lock_t lock;
 		help_frame_t *win = dynamic_cast<help_frame_t*>(win_get_magic(magic_script_error));
 		if (win == NULL) {
 			win = new help_frame_t();
@@ -103,6 +107,8 @@ void script_vm_t::errorfunc(HSQUIRRELVM vm, const SQChar *s_, ...)
 
 void export_include(HSQUIRRELVM vm, const char* include_path); // api_include.cc
 
+vector_tpl<script_vm_t*> script_vm_t::all_scripts;
+
 // virtual machine
 script_vm_t::script_vm_t(const char* include_path_, const char* log_name)
 {
@@ -137,6 +143,16 @@ script_vm_t::script_vm_t(const char* include_path_, const char* log_name)
 	sq_setforeignptr(vm, this);
 	sq_setforeignptr(thread, this);
 
+	name = log_name;
+	if (name.size() > 4  &&  name.compare(name.size() - 4, 4, ".log") == 0) {
+		name.resize(name.size() - 4);
+	}
+	if (env_t::script_profile) {
+		sq_profile_start(vm);
+		sq_profile_start(thread);
+	}
+	all_scripts.append(this);
+
 	error_msg = NULL;
 	include_path = include_path_;
 	// register libraries
@@ -154,6 +170,8 @@ script_vm_t::script_vm_t(const char* include_path_, const char* log_name)
 
 script_vm_t::~script_vm_t()
 {
+	write_profile(NULL);
+	all_scripts.remove(this);
 	unregister_vm(thread);
 	unregister_vm(vm);
 	// remove from suspended calls list
@@ -165,10 +183,46 @@ script_vm_t::~script_vm_t()
 	delete log;
 }
 
+void script_vm_t::write_profile(cbuffer_t *summary) const
+{
+	if (!sq_profile_active(vm)) {
+		return;
+	}
+
+	const char *suffix[2] = { ".ops.folded", ".time.folded" };
+	for(int wall_time = 0; wall_time < 2; wall_time++) {
+		const std::string file_name = std::string(env_t::user_dir) + name + suffix[wall_time];
+		FILE *f = dr_fopen(file_name.c_str(), "w");
+		if (f == NULL) {
+			dbg->warning("script_vm_t::write_profile", "Cannot write %s", file_name.c_str());
+			continue;
+		}
+		sq_profile_write(vm, f, name.c_str(), wall_time);
+		sq_profile_write(thread, f, (name + ";thread").c_str(), wall_time);
+		fclose(f);
+	}
+
+	if (summary) {
+		summary->printf("%s:\n", name.c_str());
+		sq_profile_summary(vm, *summary, 10);
+		summary->printf("%s (thread):\n", name.c_str());
+		sq_profile_summary(thread, *summary, 10);
+	}
+}
+
+
+void script_vm_t::write_all_profiles(cbuffer_t *summary)
+{
+	for(script_vm_t *script : all_scripts) {
+		script->write_profile(summary);
+	}
+}
+
+
 const char* script_vm_t::call_script(const char* filename, uint32 ops)
 {
 	// load script
-	if (!SQ_SUCCEEDED(sqstd_loadfile(vm, filename, true))) {
+	if (!SQ_SUCCEEDED(script_loader_t::load_file(vm, filename))) {
 		return "Reading / compiling script failed";
 	}
 	// call it
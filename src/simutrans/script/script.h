@@ -16,8 +16,10 @@
 #include "../utils/plainstring.h"
 #include <string>
 
+class cbuffer_t;
 class log_t;
 template<class key_t, class value_t> class inthashtable_tpl;
+template<class T> class vector_tpl;
 void sq_setwakeupretvalue(HSQUIRRELVM v); //sq_extensions
 
 /**
@@ -154,6 +156,18 @@ public:
 	 */
 	void clear_pending_callback();
 
+	/**
+	 * Writes the profile of the script functions (if env_t::script_profile is set)
+	 * to NAME.ops.folded and NAME.time.folded in the user directory, where NAME is the log file name without extension.
+	 * The files can be turned into flamegraphs by flamegraph.pl.
+	 * Called when the script is closed.
+	 * @param summary if not NULL, the most expensive functions are printed there
+	 */
+	void write_profile(cbuffer_t *summary) const;
+
+	/// writes the profiles of all running scripts
+	static void write_all_profiles(cbuffer_t *summary);
+
 private:
 	/// virtual machine running everything
 	HSQUIRRELVM vm;
@@ -164,6 +178,12 @@ private:
 	/// our log file
 	log_t* log;
 
+	/// log file name without extension
+	std::string name;
+
+	/// all scripts for write_all_profiles()
+	static vector_tpl<script_vm_t*> all_scripts;
+
 	plainstring error_msg;
 
 	/// path to files to #include
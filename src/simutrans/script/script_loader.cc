@@ -8,7 +8,25 @@
 #include "api/api.h"
 #include "export_objs.h"
 #include "../dataobj/environment.h"
+#include "../network/checksum.h"
+#include "../pathes.h"
+#include "../simversion.h"
+#include "../sys/simsys.h"
 #include "../utils/cbuffer.h"
+#include "../../squirrel/sqstdio.h"
+
+#include <string.h>
+#include <string>
+
+
+/// magic and format version of the cache file, followed by the signature of the source,
+/// the length of the bytecode and its hash
+/// increase the number whenever the bytecode of our squirrel changes
+#define SCRIPT_CACHE_MAGIC "SimNutC2"
+#define SCRIPT_CACHE_MAGIC_LEN (8)
+#define SCRIPT_CACHE_SIGNATURE_LEN (40)
+#define SCRIPT_CACHE_LENGTH_LEN (8)
+#define SCRIPT_CACHE_HEAD_LEN (SCRIPT_CACHE_MAGIC_LEN + 2*SCRIPT_CACHE_SIGNATURE_LEN + SCRIPT_CACHE_LENGTH_LEN)
 
 
 
@@ -74,3 +92,163 @@ void script_loader_t::load_compatibility_script(script_vm_t *script)
 		}
 	}
 }
+
+
+/// bytecode in memory, read by sq_readclosure()
+struct cache_reader_t {
+	const char *pos;
+	size_t left;
+};
+
+
+static SQInteger read_cache(SQUserPointer reader, SQUserPointer buf, SQInteger size)
+{
+	cache_reader_t *r = (cache_reader_t *)reader;
+	if(  (size_t)size > r->left  ) {
+		return -1;
+	}
+	memcpy(buf, r->pos, size);
+	r->pos += size;
+	r->left -= size;
+	return size;
+}
+
+
+static SQInteger write_cache(SQUserPointer str, SQUserPointer buf, SQInteger size)
+{
+	((std::string *)str)->append((const char *)buf, size);
+	return size;
+}
+
+
+/// writes the result of @p sha as 40 hex digits to @p out
+static void sha1_to_hex(SHA1 &sha, char *out)
+{
+	sha1_hash_t hash;
+	sha.Result(hash);
+	for(  uint8 i = 0;  i < 20;  i++  ) {
+		sprintf(out + 2*i, "%2.2X", hash[i]);
+	}
+}
+
+
+SQRESULT script_loader_t::load_file(HSQUIRRELVM vm, const char* filename)
+{
+	if(  !env_t::script_cache  ) {
+		return sqstd_loadfile(vm, filename, true);
+	}
+
+	// read the whole source, so it is hashed and compiled from the same text
+	FILE *f = dr_fopen(filename, "rb");
+	if(  !f  ) {
+		return sqstd_loadfile(vm, filename, true); // reports the error
+	}
+	std::string source;
+	char buf[4096];
+	size_t n;
+	while(  (n = fread(buf, 1, sizeof(buf), f)) > 0  ) {
+		source.append(buf, n);
+	}
+	fclose(f);
+
+	const char *text = source.c_str();
+	size_t len = source.size();
+	if(  len >= 3  &&  memcmp(text, "\xEF\xBB\xBF", 3) == 0  ) {
+		// skip utf8 byte order mark
+		text += 3;
+		len -= 3;
+	}
+	else if(  len >= 2  &&  ((uint8)text[0] == 0xFF  ||  (uint8)text[0] == 0xFE  ||  (uint16)((uint8)text[0] | ((uint8)text[1] << 8)) == SQ_BYTECODE_STREAM_TAG)  ) {
+		// utf16 or already compiled: nothing to gain
+		return sqstd_loadfile(vm, filename, true);
+	}
+
+	// the name is stored in the closure for error messages, thus part of the signature
+	SHA1 sha;
+	sha.Input(SCRIPT_CACHE_MAGIC SQUIRREL_VERSION VERSION_NUMBER, strlen(SCRIPT_CACHE_MAGIC SQUIRREL_VERSION VERSION_NUMBER));
+	sha.Input(filename, strlen(filename) + 1);
+	sha.Input(text, len);
+	char signature[SCRIPT_CACHE_SIGNATURE_LEN + 1];
+	sha1_to_hex(sha, signature);
+
+	// one file per script, so edited scripts do not fill the directory
+	checksum_t name_chk;
+	name_chk.input(filename);
+	name_chk.finish();
+	const std::string cache_name = std::string(env_t::user_dir) + CACHE_PATH_X "script-" + name_chk.get_str() + ".cnut";
+
+	if(  FILE *in = dr_fopen(cache_name.c_str(), "rb")  ) {
+		char head[SCRIPT_CACHE_HEAD_LEN];
+		const bool valid = fread(head, SCRIPT_CACHE_HEAD_LEN, 1, in) == 1
+			&&  memcmp(head, SCRIPT_CACHE_MAGIC, SCRIPT_CACHE_MAGIC_LEN) == 0
+			&&  memcmp(head + SCRIPT_CACHE_MAGIC_LEN, signature, SCRIPT_CACHE_SIGNATURE_LEN) == 0;
+		bool ok = false;
+		if(  valid  ) {
+			// the bytecode must be complete and unchanged, sq_readclosure() does not check it
+			char length[SCRIPT_CACHE_LENGTH_LEN + 1];
+			memcpy(length, head + SCRIPT_CACHE_MAGIC_LEN + SCRIPT_CACHE_SIGNATURE_LEN, SCRIPT_CACHE_LENGTH_LEN);
+			length[SCRIPT_CACHE_LENGTH_LEN] = 0;
+			const long body_len = strtol(length, NULL, 16);
+			fseek(in, 0, SEEK_END);
+			const long file_len = ftell(in);
+			fseek(in, SCRIPT_CACHE_HEAD_LEN, SEEK_SET);
+
+			const bool complete = body_len > 0  &&  body_len == file_len - SCRIPT_CACHE_HEAD_LEN;
+			std::string body(complete ? body_len : 0, 0);
+			if(  complete  &&  fread(&body[0], body_len, 1, in) == 1  ) {
+				SHA1 body_sha;
+				body_sha.Input(body.data(), body_len);
+				char body_hash[SCRIPT_CACHE_SIGNATURE_LEN + 1];
+				sha1_to_hex(body_sha, body_hash);
+				if(  memcmp(head + SCRIPT_CACHE_MAGIC_LEN + SCRIPT_CACHE_SIGNATURE_LEN + SCRIPT_CACHE_LENGTH_LEN, body_hash, SCRIPT_CACHE_SIGNATURE_LEN) == 0  ) {
+					cache_reader_t reader = { body.data(), (size_t)body_len };
+					ok = SQ_SUCCEEDED(sq_readclosure(vm, read_cache, &reader));
+				}
+			}
+		}
+		fclose(in);
+		if(  ok  ) {
+			return SQ_OK;
+		}
+		if(  valid  ) {
+			dbg->warning("script_loader_t::load_file", "Cache %s for %s is damaged", cache_name.c_str(), filename);
+		}
+	}
+
+	if(  SQ_FAILED(sq_compilebuffer(vm, text, len, filename, true))  ) {
+		return SQ_ERROR;
+	}
+
+	// store the closure for the next time
+	std::string body;
+	if(  SQ_FAILED(sq_writeclosure(vm, write_cache, &body))  ) {
+		dbg->warning("script_loader_t::load_file", "Cannot write cache %s for %s", cache_name.c_str(), filename);
+		return SQ_OK;
+	}
+	SHA1 body_sha;
+	body_sha.Input(body.data(), body.size());
+	char body_info[SCRIPT_CACHE_LENGTH_LEN + SCRIPT_CACHE_SIGNATURE_LEN + 1];
+	sprintf(body_info, "%8.8X", (unsigned)body.size());
+	sha1_to_hex(body_sha, body_info + SCRIPT_CACHE_LENGTH_LEN);
+
+	dr_mkdir((std::string(env_t::user_dir) + CACHE_PATH).c_str());
+	const std::string tmp_name = cache_name + ".tmp";
+	if(  FILE *out = dr_fopen(tmp_name.c_str(), "wb")  ) {
+		fwrite(SCRIPT_CACHE_MAGIC, SCRIPT_CACHE_MAGIC_LEN, 1, out);
+		fwrite(signature, SCRIPT_CACHE_SIGNATURE_LEN, 1, out);
+		fwrite(body_info, SCRIPT_CACHE_LENGTH_LEN + SCRIPT_CACHE_SIGNATURE_LEN, 1, out);
+		fwrite(body.data(), 1, body.size(), out);
+		bool ok = !ferror(out);
+		// a failed flush would leave a truncated cache
+		ok &= fclose(out) == 0;
+		if(  ok  ) {
+			dr_remove(cache_name.c_str());
+			if(  dr_rename(tmp_name.c_str(), cache_name.c_str()) == 0  ) {
+				return SQ_OK;
+			}
+		}
+		dr_remove(tmp_name.c_str());
+	}
+	dbg->warning("script_loader_t::load_file", "Cannot write cache %s for %s", cache_name.c_str(), filename);
+	return SQ_OK;
+}
@@ -7,6 +7,8 @@
 #define SCRIPT_SCRIPT_LOADER_H
 
 
+#include "../../squirrel/squirrel.h"
+
 class script_vm_t;
 
 struct script_loader_t
@@ -26,6 +28,13 @@ struct script_loader_t
 	 * loads necessary compatibility scripts
 	 */
 	static void load_compatibility_script(script_vm_t *script);
+
+	/**
+	 * Compiles a script file and pushes the closure, like sqstd_loadfile().
+	 * If env_t::script_cache is set, the compiled closure is kept in the
+	 * user directory (cache/) and read from there while the file is unchanged.
+	 */
+	static SQRESULT load_file(HSQUIRRELVM vm, const char* filename);
 };
 
 #endif
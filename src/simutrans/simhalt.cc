@@ -77,6 +77,59 @@ static vector_tpl<convoihandle_t>stale_convois;
 static vector_tpl<linehandle_t>stale_lines;
 
 
+/**
+ * Cache for search_route(): unless overcrowded stops are avoided, the route only depends
+ * on the start and end halts and on the connections. The passengers of a city start from
+ * few stops and go to few stops, so most searches are answered from here.
+ * All entries become invalid whenever the connections change.
+ */
+#define ROUTE_CACHE_SIZE (4096)
+#define ROUTE_CACHE_MAX_HALTS (16)
+
+struct route_cache_entry_t {
+	uint32 generation; ///< valid only if equal to route_cache_generation
+	uint8 catg_idx;
+	uint8 start_count;
+	uint8 end_count;
+	uint16 halt_ids[ROUTE_CACHE_MAX_HALTS]; ///< start halts, then end halts
+	int result;
+	halthandle_t target, via;
+	halthandle_t return_target, return_via;
+};
+
+static route_cache_entry_t route_cache[ROUTE_CACHE_SIZE];
+static uint32 route_cache_generation = 1;
+static uint16 route_cache_max_transfers = 0;
+static uint16 route_cache_max_hops = 0;
+
+
+static void invalidate_route_cache()
+{
+	route_cache_generation++;
+	if(  route_cache_generation == 0  ) {
+		// wrapped around
+		for(  uint32 i = 0;  i < ROUTE_CACHE_SIZE;  i++  ) {
+			route_cache[i].generation = 0;
+		}
+		route_cache_generation = 1;
+	}
+}
+
+
+static int remember_route(route_cache_entry_t *entry, int result, const ware_t &ware, const ware_t *return_ware)
+{
+	if(  entry  ) {
+		entry->result = result;
+		entry->target = ware.get_target_halt();
+		entry->via = ware.get_via_halt();
+		entry->return_target = return_ware->get_target_halt();
+		entry->return_via = return_ware->get_via_halt();
+		entry->generation = route_cache_generation;
+	}
+	return result;
+}
+
+
 void haltestelle_t::reset_routing()
 {
 	reconnect_counter = welt->get_schedule_counter()-1;
@@ -567,6 +620,8 @@ haltestelle_t::~haltestelle_t()
 	if (i != 1) {
 		dbg->error("haltestelle_t::~haltestelle_t()", "handle %i found %i times in haltlist!", self.get_id(), i );
 	}
+	// the handle may be reused for another halt
+	invalidate_route_cache();
 
 	// free name
 	set_name(NULL);
@@ -1313,6 +1368,7 @@ sint32 haltestelle_t::rebuild_connections()
 		all_links[i].clear();
 		consecutive_halts[i].clear();
 	}
+	invalidate_route_cache();
 	old_sort_mode = 255; // might result in error in routing
 
 	last_catg_index = 255; // must reroute everything
@@ -1596,6 +1652,7 @@ void haltestelle_t::fill_connected_component(uint8 catg_idx, uint16 comp)
 
 void haltestelle_t::rebuild_connected_components()
 {
+	invalidate_route_cache();
 	for(uint8 catg_idx = 0; catg_idx<goods_manager_t::get_max_catg_index(); catg_idx++) {
 		for(halthandle_t halt : alle_haltestellen) {
 			if (halt->all_links[catg_idx].catg_connected_component == UNDECIDED_CONNECTED_COMPONENT) {
@@ -1757,7 +1814,7 @@ uint8 haltestelle_t::last_search_ware_catg_idx = 255;
  * @param return_ware
  * @param[out] ware
  */
-int haltestelle_t::search_route( const halthandle_t *const start_halts, const uint16 start_halt_count, const bool no_routing_over_overcrowding, ware_t &ware, ware_t *const return_ware )
+int haltestelle_t::search_route( const halthandle_t *const start_halts, const uint16 start_halt_count, const bool no_routing_over_overcrowding, ware_t &ware, ware_t *return_ware )
 {
 	const uint8 ware_catg_idx = ware.get_desc()->get_catg_index();
 	const uint8 ware_idx = ware.get_desc()->get_index();
@@ -1818,6 +1875,56 @@ int haltestelle_t::search_route( const halthandle_t *const start_halts, const ui
 		}
 		return NO_ROUTE;
 	}
+
+	uint16 const max_transfers = welt->get_settings().get_max_transfers();
+	uint16 const max_hops      = welt->get_settings().get_max_hops();
+
+	// maybe this search was done before
+	route_cache_entry_t *cache_entry = NULL;
+	ware_t cache_return_ware(ware.get_desc());
+	if(  !no_routing_over_overcrowding  &&  start_halt_count + end_halts.get_count() <= ROUTE_CACHE_MAX_HALTS  ) {
+		if(  max_transfers != route_cache_max_transfers  ||  max_hops != route_cache_max_hops  ) {
+			route_cache_max_transfers = max_transfers;
+			route_cache_max_hops = max_hops;
+			invalidate_route_cache();
+		}
+
+		uint16 ids[ROUTE_CACHE_MAX_HALTS];
+		uint32 hash = 2166136261u ^ ware_catg_idx;
+		for(  uint16 s=0;  s<start_halt_count;  ++s  ) {
+			ids[s] = start_halts[s].get_id();
+			hash = (hash ^ ids[s]) * 16777619u;
+		}
+		for(  uint32 e=0;  e<end_halts.get_count();  ++e  ) {
+			ids[start_halt_count+e] = end_halts[e].get_id();
+			hash = (hash ^ ids[start_halt_count+e]) * 16777619u;
+		}
+		const uint32 id_count = start_halt_count + end_halts.get_count();
+
+		cache_entry = &route_cache[ hash % ROUTE_CACHE_SIZE ];
+		if(  cache_entry->generation == route_cache_generation  &&  cache_entry->catg_idx == ware_catg_idx  &&
+			cache_entry->start_count == start_halt_count  &&  cache_entry->end_count == end_halts.get_count()  &&
+			memcmp( cache_entry->halt_ids, ids, id_count * sizeof(uint16) ) == 0  ) {
+			ware.set_target_halt( cache_entry->target );
+			ware.set_via_halt( cache_entry->via );
+			if(  return_ware  ) {
+				return_ware->set_target_halt( cache_entry->return_target );
+				return_ware->set_via_halt( cache_entry->return_via );
+			}
+			return cache_entry->result;
+		}
+
+		// search and remember the result
+		cache_entry->generation = 0;
+		cache_entry->catg_idx = ware_catg_idx;
+		cache_entry->start_count = start_halt_count;
+		cache_entry->end_count = end_halts.get_count();
+		memcpy( cache_entry->halt_ids, ids, id_count * sizeof(uint16) );
+		if(  return_ware == NULL  ) {
+			return_ware = &cache_return_ware;
+		}
+	}
+
 	// invalidate search history
 	last_search_origin = halthandle_t();
 
@@ -1837,8 +1944,6 @@ int haltestelle_t::search_route( const halthandle_t *const start_halts, const ui
 		markers[ halt_id ] = current_marker;
 	}
 
-	uint16 const max_transfers = welt->get_settings().get_max_transfers();
-	uint16 const max_hops      = welt->get_settings().get_max_hops();
 	uint16 allocation_pointer = 0;
 	uint16 best_destination_weight = 65535u; // best weight among all destinations
 
@@ -1872,7 +1977,7 @@ int haltestelle_t::search_route( const halthandle_t *const start_halts, const ui
 	{
 		if(  overcrowded_nodes == open_list.get_count()  ) {
 			// all unexplored routes go over overcrowded stations
-			return ROUTE_OVERCROWDED;
+			return remember_route( cache_entry, ROUTE_OVERCROWDED, ware, return_ware );
 		}
 
 		// take node out of open list
@@ -1915,7 +2020,7 @@ int haltestelle_t::search_route( const halthandle_t *const start_halts, const ui
 				assert( halt_data[ transfer_halt.get_id() ].transfer.get_id() );
 				return_ware->set_target_halt( halt_data[ transfer_halt.get_id() ].transfer );
 			}
-			return current_halt_data.overcrowded ? ROUTE_OVERCROWDED : ROUTE_OK;
+			return remember_route( cache_entry, current_halt_data.overcrowded ? ROUTE_OVERCROWDED : ROUTE_OK, ware, return_ware );
 		}
 
 		// check if the current halt is already in closed list
@@ -2019,7 +2124,7 @@ int haltestelle_t::search_route( const halthandle_t *const start_halts, const ui
 		return_ware->set_target_halt( halthandle_t() );
 		return_ware->set_via_halt( halthandle_t() );
 	}
-	return NO_ROUTE;
+	return remember_route( cache_entry, NO_ROUTE, ware, return_ware );
 }
 
 
@@ -14,6 +14,7 @@
 #endif
 
 #include <stdio.h>
+#include <math.h>
 #include <string>
 #include <new>
 
@@ -23,6 +24,7 @@
 #include "world/simworld.h"
 #include "simware.h"
 #include "display/simview.h"
+#include "display/viewport.h"
 #include "gui/simwin.h"
 #include "gui/gui_theme.h"
 #include "gui/messagebox.h"
@@ -251,6 +253,99 @@ static void show_times(karte_t *welt, main_view_t *view)
 #endif
 
 
+/**
+ * Renders the world along a fixed circle around the map centre at every
+ * third zoom level and prints the frame times and a checksum of the screen.
+ * Nothing is simulated meanwhile, so the same save gives the same checksums.
+ */
+static void benchmark_view(karte_t *welt, main_view_t *view, int frames)
+{
+	intr_set_view(view);
+	intr_disable();
+	destroy_all_win(true);
+
+	viewport_t *viewport = welt->get_viewport();
+	const koord center = welt->get_size() / 2;
+	const double radius = min( welt->get_size().x, welt->get_size().y ) / 4;
+	const scr_rect screen( gfx->get_screen_size() );
+
+	printf( "benchmark_view: %d frames per zoom, %d threads, screen %dx%d\n", frames, env_t::num_threads, screen.w, screen.h );
+
+	// start with the largest tiles, zoom_factor_up() ends at zoom 2/1
+	while(  gfx->zoom_factor_up()  ) {
+	}
+
+	uint32 checksum_all = 2166136261u;
+	bool zoomed;
+	do {
+		viewport->metrics_updated();
+
+		// first frame rezooms the images, so it is not counted, and neither is the background rezoom
+		viewport->change_world_position( center + koord( (sint16)radius, 0 ) );
+		view->display(true);
+		gfx->finish_rezoom();
+
+		uint32 total_ms = 0, min_ms = 0xFFFFFFFFu, max_ms = 0;
+		uint32 checksum = 2166136261u;
+		for(  int i = 0;  i < frames;  i++  ) {
+			const double angle = (6.28318530718 * i) / frames;
+			viewport->change_world_position( center + koord( (sint16)(radius * cos(angle)), (sint16)(radius * sin(angle)) ) );
+
+			const uint32 ms = dr_time();
+			view->display(true);
+			dr_prepare_flush();
+			dr_flush();
+			const uint32 frame_ms = dr_time() - ms;
+
+			total_ms += frame_ms;
+			min_ms = min( min_ms, frame_ms );
+			max_ms = max( max_ms, frame_ms );
+			checksum = (checksum ^ gfx->get_screen_checksum(screen)) * 16777619u;
+		}
+		checksum_all = (checksum_all ^ checksum) * 16777619u;
+
+		printf( "benchmark_view: tile width %3d: %u ms, %.2f ms/frame (min %u, max %u), checksum %08x\n",
+			gfx->get_current_tile_raster_width(), total_ms, frames > 0 ? (double)total_ms / frames : 0.0, frames > 0 ? min_ms : 0, max_ms, checksum );
+
+		zoomed = false;
+		for(  int z = 0;  z < 3;  z++  ) {
+			zoomed |= gfx->zoom_factor_down() != 0;
+		}
+	} while(  zoomed  );
+
+	printf( "benchmark_view: checksum %08x\n", checksum_all );
+	fflush( stdout );
+}
+
+
+/**
+ * Creates a new map of size x size tiles with the default settings and prints the time
+ * and a checksum of heights and climates. The times of the phases are in the log.
+ */
+static void benchmark_mapgen(karte_t *welt, sint16 size)
+{
+	settings_t sets = env_t::default_settings;
+	sets.set_size( size, size );
+
+	printf( "benchmark_mapgen: %dx%d map number %d, %d threads\n", size, size, sets.get_map_number(), env_t::num_threads );
+
+	const uint32 ms = dr_time();
+	welt->init( &sets, 0 );
+	const uint32 total_ms = dr_time() - ms;
+
+	uint32 checksum = 2166136261u;
+	for(  sint16 y = 0;  y < welt->get_size().y;  y++  ) {
+		for(  sint16 x = 0;  x < welt->get_size().x;  x++  ) {
+			checksum = (checksum ^ (uint8)welt->lookup_hgt( koord(x, y) )) * 16777619u;
+			checksum = (checksum ^ welt->get_climate( koord(x, y) )) * 16777619u;
+		}
+	}
+
+	printf( "benchmark_mapgen: %u ms, checksum %08x\n", total_ms, checksum );
+	fflush( stdout );
+}
+
+
 // some routines for the modal display
 static bool never_quit() { return false; }
 static bool no_language() { return translator::get_language()!=-1; }
@@ -411,11 +506,17 @@ void print_help()
 		" -res N              starts in specified resolution: \n"
 		"                      1=640x480, 2=800x600, 3=1024x768, 4=1280x1024\n"
 		" -scenario NAME      Load scenario NAME\n"
+		" -script_profile     records time and opcodes of script functions and writes\n"
+		"                     them in flamegraph format to the user directory\n"
 		" -screensize WxH     set screensize to width W and height H\n"
 		" -server [PORT]      starts program as server (for network game)\n"
 		"                     without port specified uses 13353\n"
 		" -announce           Enable server announcements\n"
 		" -autodpi            Automatic screen scaling for high DPI screens\n"
+		" -benchmark_view N   renders N frames per zoom level of the loaded game,\n"
+		"                     prints the frame times and quits\n"
+		" -benchmark_mapgen N creates a map of NxN tiles with the default settings,\n"
+		"                     prints the time and quits\n"
 		" -screen_scale N     Manual screen scaling to N percent (0=off)\n"
 		"                     Ignored when -autodpi is specified\n"
 		" -server_dns FQDN/IP FQDN or IP address of server for announcements\n"
@@ -700,6 +801,10 @@ int simu_main(int argc, char** argv)
 		env_t::default_settings.set_freeplay( true );
 	}
 
+	if(  args.has_arg("-script_profile")  ) {
+		env_t::script_profile = true;
+	}
+
 #ifdef __ANDROID__
 	// always save and reload on Android
 	env_t::reload_and_save_on_quit = true;
@@ -1618,6 +1723,20 @@ int simu_main(int argc, char** argv)
 	}
 #endif
 
+	// render benchmark, mostly useful with -load and the offscreen backend
+	if(  args.has_arg("-benchmark_view")  ) {
+		const char *frames = args.gimme_arg("-benchmark_view", 1);
+		benchmark_view( welt, view, frames ? max( 1, atoi(frames) ) : 100 );
+		env_t::quit_simutrans = true;
+	}
+
+	// map creation benchmark, uses the default settings except for the size
+	if(  args.has_arg("-benchmark_mapgen")  ) {
+		const char *size = args.gimme_arg("-benchmark_mapgen", 1);
+		benchmark_mapgen( welt, size ? clamp( atoi(size), 16, 32766 ) : 1024 );
+		env_t::quit_simutrans = true;
+	}
+
 	// finish after a certain month? (must be entered decimal, i.e. 12*year+month
 	if(  args.has_arg("-until")  ) {
 		const char *until = args.gimme_arg("-until", 1);
@@ -48,6 +48,10 @@
 #	if !defined __AMIGA__ && !defined __BEOS__
 #		include <unistd.h>
 #	endif
+#	if !defined __AMIGA__
+#		include <fcntl.h>
+#		include <sys/mman.h>
+#	endif
 #	ifdef __ANDROID__
 #       include "../utils/searchfolder.h"
 #		include <SDL.h>
@@ -444,6 +448,78 @@ gzFile dr_gzopen(const char *path, const char *mode)
 }
 
 
+void *dr_map_file(const char *filename, size_t &size)
+{
+#ifdef _WIN32
+	HANDLE const file = CreateFileW(U16View(filename), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return NULL;
+	}
+
+	LARGE_INTEGER len;
+	if (!GetFileSizeEx(file, &len)  ||  len.QuadPart <= 0  ||  (uint64)len.QuadPart > (uint64)(size_t)-1) {
+		CloseHandle(file);
+		return NULL;
+	}
+
+	// the view keeps the file open, so the handles can be closed right away
+	HANDLE const mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if (!mapping) {
+		return NULL;
+	}
+
+	void *data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!data) {
+		return NULL;
+	}
+
+	size = (size_t)len.QuadPart;
+	return data;
+#elif !defined __AMIGA__
+	const int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	struct stat s;
+	if (fstat(fd, &s) != 0  ||  !S_ISREG(s.st_mode)  ||  s.st_size <= 0) {
+		close(fd);
+		return NULL;
+	}
+
+	// private writable mapping, so callers may patch the data without touching the file
+	void *data = mmap(NULL, (size_t)s.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+
+	size = (size_t)s.st_size;
+	return data;
+#else
+	(void)filename;
+	(void)size;
+	return NULL;
+#endif
+}
+
+
+void dr_unmap_file(void *data, size_t size)
+{
+#ifdef _WIN32
+	(void)size;
+	UnmapViewOfFile(data);
+#elif !defined __AMIGA__
+	munmap(data, size);
+#else
+	(void)data;
+	(void)size;
+#endif
+}
+
+
 bool check_and_set_dir( const char *path, const char *info, char *result, const char *testfile)
 {
 	if(  path  &&  *path  ) {
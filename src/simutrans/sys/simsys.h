@@ -153,6 +153,14 @@ gzFile dr_gzopen(const char *path, const char *mode);
 /// Functions the same as @ref stat except @p path must be UTF-8 encoded.
 int dr_stat(const char *path, struct stat *buf);
 
+/// Maps the regular file @p filename (UTF-8 encoded) copy-on-write into memory.
+/// Returns NULL if the file cannot be mapped (e.g. it is empty or the OS has no mmap).
+/// @param[out] size Length of the mapping in bytes
+void *dr_map_file(const char *filename, size_t &size);
+
+/// Releases a mapping returned by @ref dr_map_file.
+void dr_unmap_file(void *data, size_t size);
+
 /**
 * Check if the directory exists and if so set the result variable to it
 * If the directory doesn't exist previously, it will attempt to create it if testfile is not provided
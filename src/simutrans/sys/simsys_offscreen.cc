@@ -0,0 +1,285 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+/*
+ * Headless backend with a real 16 bit framebuffer in memory.
+ * Everything is drawn like with a window, but nothing is ever shown.
+ * Used for rendering benchmarks (-benchmark_view) on machines without display.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifndef _MSC_VER
+#include <unistd.h>
+#include <sys/time.h>
+#else
+// need timeGetTime
+#include <mmsystem.h>
+#endif
+
+#include <signal.h>
+#include <stdlib.h>
+
+#include "simsys.h"
+#include "../macros.h"
+#include "../simdebug.h"
+#include "../simevent.h"
+#include "../display/simgraph.h"
+
+
+static bool sigterm_received = false;
+
+#if COLOUR_DEPTH != 16
+#error "Offscreen only compiles with color depth=16"
+#endif
+
+// size if nothing else was requested
+#define OFFSCREEN_WIDTH (1920)
+#define OFFSCREEN_HEIGHT (1080)
+
+static PIXVAL *framebuffer = NULL;
+static int framebuffer_pitch = 0;
+static int framebuffer_height = 0;
+
+
+bool dr_set_screen_scale(sint16)
+{
+	// no autoscaling as we have no display ...
+	return false;
+}
+
+
+sint16 dr_get_screen_scale()
+{
+	return 100;
+}
+
+
+bool dr_os_init(const int*)
+{
+	// prepare for next event
+	sys_event.type = SIM_NOEVENT;
+	sys_event.code = 0;
+	return true;
+}
+
+
+resolution dr_query_screen_resolution()
+{
+	resolution const res = { OFFSCREEN_WIDTH, OFFSCREEN_HEIGHT };
+	return res;
+}
+
+
+static bool alloc_framebuffer(int w, int h)
+{
+	// same alignment as the other backends
+	const int pitch = max( (w + 15) & 0x7FF0, 16 );
+	PIXVAL *buf = (PIXVAL *)calloc( (size_t)pitch * max(h, 1), sizeof(PIXVAL) );
+	if(  !buf  ) {
+		dbg->error( "alloc_framebuffer(offscreen)", "Cannot allocate %i x %i framebuffer", pitch, h );
+		return false;
+	}
+	free( framebuffer );
+	framebuffer = buf;
+	framebuffer_pitch = pitch;
+	framebuffer_height = h;
+	return true;
+}
+
+
+// open the "window"
+int dr_os_open(const scr_size window_size, sint16)
+{
+	const int w = max( 1, window_size.w );
+	const int h = max( 1, window_size.h );
+	if(  !alloc_framebuffer( w, h )  ) {
+		return 0;
+	}
+	DBG_MESSAGE("dr_os_open(offscreen)", "framebuffer width=%d, height=%d (pitch %d)", w, h, framebuffer_pitch );
+
+	gfx->set_screen_actual_width( w );
+	gfx->set_screen_height( h );
+	return framebuffer_pitch;
+}
+
+
+void dr_os_close()
+{
+	free( framebuffer );
+	framebuffer = NULL;
+}
+
+
+// resizes screen
+int dr_textur_resize(unsigned short** const textur, int w, int h)
+{
+	if(  (max( (w + 15) & 0x7FF0, 16 ) != framebuffer_pitch  ||  h != framebuffer_height)  &&  alloc_framebuffer( w, h )  ) {
+		*textur = dr_textur_init();
+	}
+	gfx->set_screen_actual_width( w );
+	return framebuffer_pitch;
+}
+
+
+unsigned short *dr_textur_init()
+{
+	return (unsigned short *)framebuffer;
+}
+
+
+/**
+ * Transform a 24 bit RGB color into the system format (RGB565 like SDL2).
+ * @return converted color value
+ */
+PIXVAL get_system_color(rgb888_t col)
+{
+	return ((col.r & 0xF8) << 8) | ((col.g & 0xFC) << 3) | (col.b >> 3);
+}
+
+
+void dr_prepare_flush()
+{
+}
+
+
+void dr_flush()
+{
+	gfx->flush_framebuffer();
+}
+
+
+void dr_textur(int, int, int, int)
+{
+}
+
+
+bool move_pointer(int, int)
+{
+	return false;
+}
+
+
+void set_pointer(int)
+{
+}
+
+
+void GetEvents()
+{
+	if(  sigterm_received  ) {
+		sys_event.type = SIM_SYSTEM;
+		sys_event.code = SYSTEM_QUIT;
+	}
+}
+
+
+void show_pointer(int)
+{
+}
+
+
+void ex_ord_update_mx_my()
+{
+}
+
+
+#ifndef _MSC_VER
+static timeval first;
+#endif
+
+uint32 dr_time()
+{
+#ifndef _MSC_VER
+	timeval second;
+	gettimeofday(&second,NULL);
+	if (first.tv_usec > second.tv_usec) {
+		// since those are often unsigned
+		second.tv_usec += 1000000;
+		second.tv_sec--;
+	}
+
+	return (second.tv_sec - first.tv_sec)*1000ul + (second.tv_usec - first.tv_usec)/1000ul;
+#else
+	return timeGetTime();
+#endif
+}
+
+
+void dr_sleep(uint32 msec)
+{
+#ifdef _WIN32
+	Sleep( msec );
+#else
+	usleep( 1000u * msec );
+#endif
+}
+
+
+void dr_start_textinput()
+{
+}
+
+
+void dr_stop_textinput()
+{
+}
+
+
+void dr_notify_input_pos(scr_coord)
+{
+}
+
+
+static void offscreen_sigterm(int)
+{
+	DBG_MESSAGE("Received SIGTERM", "exiting...");
+	sigterm_received = 1;
+}
+
+
+const char* dr_get_locale()
+{
+	return "";
+}
+
+
+bool dr_has_fullscreen()
+{
+	return false;
+}
+
+
+sint16 dr_get_fullscreen()
+{
+	return 0;
+}
+
+
+sint16 dr_toggle_borderless()
+{
+	return 0;
+}
+
+
+sint16 dr_suspend_fullscreen()
+{
+	return 0;
+}
+
+
+void dr_restore_fullscreen(sint16) {}
+
+
+int main(int argc, char **argv)
+{
+	signal( SIGTERM, offscreen_sigterm );
+#ifndef _MSC_VER
+	gettimeofday(&first,NULL);
+#endif
+	return sysmain(argc, argv);
+}
@@ -1476,7 +1476,8 @@ void two_click_tool_t::start_at(koord3d& new_start)
 {
 	first_click_var = false;
 	start = new_start;
-	if (is_local_execution()) {
+	if (can_use_gui()) {
+		// no marker for scripts, they may plan in parallel
 		welt->show_distance = new_start;
 		start_marker = new zeiger_t(start, NULL);
 		start_marker->set_image(get_marker_image());
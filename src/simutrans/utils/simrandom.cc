@@ -188,6 +188,10 @@ static sint32 map_w=0;
 
 void init_perlin_map( sint32 w, sint32 h )
 {
+	// the finest octave samples every second point only, so half the size
+	// plus the neighbours of the last cell is enough
+	w = w/2 + 3;
+	h = h/2 + 3;
 	map_w = w+2;
 	map = new float[map_w*(h+2)];
 	for(  sint32 y=0;  y<h+2;  y++ ) {
@@ -257,6 +261,16 @@ static double linear_interpolate(const double a, const double b, const double x)
 }
 
 
+// v1..v4 are the smoothed noise at the corners of the cell
+static double interpolate_cell(const double v1, const double v2, const double v3, const double v4, const double fractional_X, const double fractional_Y)
+{
+	const double i1 = linear_interpolate(v1 , v2 , fractional_X);
+	const double i2 = linear_interpolate(v3 , v4 , fractional_X);
+
+	return linear_interpolate(i1 , i2 , fractional_Y);
+}
+
+
 static double interpolated_noise(const double x, const double y)
 {
 	// The function floor is needed because (int) rounds always towards zero,
@@ -275,10 +289,7 @@ static double interpolated_noise(const double x, const double y)
 	const double v3 = smoothed_noise(integer_X,     integer_Y + 1);
 	const double v4 = smoothed_noise(integer_X + 1, integer_Y + 1);
 
-	const double i1 = linear_interpolate(v1 , v2 , fractional_X);
-	const double i2 = linear_interpolate(v3 , v4 , fractional_X);
-
-	return linear_interpolate(i1 , i2 , fractional_Y);
+	return interpolate_cell(v1, v2, v3, v4, fractional_X, fractional_Y);
 }
 
 
@@ -299,6 +310,65 @@ double perlin_noise_2D(const double x, const double y, const double p)
 }
 
 
+void perlin_noise_2D_line(sint32 x, sint32 y, const sint32 dx, const sint32 dy, const uint32 count, const double p, double *result)
+{
+	for(  uint32 n=0;  n<count;  n++  ) {
+		result[n] = 0.0;
+	}
+
+	for(  int  i=0;  i<6;  i++  ) {
+		const double amplitude = pow(p, (double)i);
+
+		// the cell is 64>>i points wide, so its corners are reused for many points
+		bool cell_valid = false;
+		int cell_X = 0, cell_Y = 0;
+		double v1 = 0.0, v2 = 0.0, v3 = 0.0, v4 = 0.0;
+
+		// (x * frequency) / 64.0 is exact, since frequency and 64 are powers of two,
+		// so floor() and the fraction can be calculated with integers with identical results
+		const int shift = 6 - i;
+		const sint32 mask = (1 << shift) - 1;
+		const double scale = 1.0 / (double)(1 << shift);
+
+		for(  uint32 n=0;  n<count;  n++  ) {
+			const sint32 px = x + (sint32)n*dx;
+			const sint32 py = y + (sint32)n*dy;
+
+			const int integer_X = px >> shift;
+			const int integer_Y = py >> shift;
+
+			if(  !cell_valid  ||  integer_X != cell_X  ||  integer_Y != cell_Y  ) {
+				if(  cell_valid  &&  integer_Y == cell_Y  &&  integer_X == cell_X + 1  ) {
+					// next cell in x direction shares two corners
+					v1 = v2;
+					v3 = v4;
+					v2 = smoothed_noise(integer_X + 1, integer_Y);
+					v4 = smoothed_noise(integer_X + 1, integer_Y + 1);
+				}
+				else if(  cell_valid  &&  integer_X == cell_X  &&  integer_Y == cell_Y + 1  ) {
+					// next cell in y direction
+					v1 = v3;
+					v2 = v4;
+					v3 = smoothed_noise(integer_X,     integer_Y + 1);
+					v4 = smoothed_noise(integer_X + 1, integer_Y + 1);
+				}
+				else {
+					v1 = smoothed_noise(integer_X,     integer_Y);
+					v2 = smoothed_noise(integer_X + 1, integer_Y);
+					v3 = smoothed_noise(integer_X,     integer_Y + 1);
+					v4 = smoothed_noise(integer_X + 1, integer_Y + 1);
+				}
+				cell_X = integer_X;
+				cell_Y = integer_Y;
+				cell_valid = true;
+			}
+
+			result[n] += interpolate_cell(v1, v2, v3, v4, (double)(px & mask) * scale, (double)(py & mask) * scale) * amplitude;
+		}
+	}
+}
+
+
 /* compute integer log10 */
 uint32 log10(uint32 v)
 {
@@ -36,6 +36,12 @@ void simrand_rdwr(loadsave_t *file);
 
 double perlin_noise_2D(const double x, const double y, const double persistence);
 
+/**
+ * Same as perlin_noise_2D() for the count points (x + n*dx, y + n*dy),
+ * but much faster since the cells of the octaves are shared between points.
+ */
+void perlin_noise_2D_line(sint32 x, sint32 y, const sint32 dx, const sint32 dy, const uint32 count, const double persistence, double *result);
+
 // for network debugging, i.e. finding hidden simrands in wrong places
 enum {
 	INTERACTIVE_RANDOM = 1 << 0,
@@ -178,15 +178,82 @@ static vector_tpl<rule_t *> road_rules;
 static char const* const allowed_chars_in_rule = "SsnHhTtUu";
 
 /**
- * @param pos position to check
+ * The 7x7 squares the rules test around a position.
+ * Every property of a square is read from the map only once,
+ * however many rules and rotations test it.
+ */
+class rule_area_t
+{
+public:
+	enum {
+		road      = 1 << 0,
+		fundament = 1 << 1,
+		house     = 1 << 2, ///< fundament with a building
+		stop      = 1 << 3,
+		removable = 1 << 4, ///< all objects can be removed
+		way_slope = 1 << 5, ///< is_way_double() for the city road
+		looked_up = 1 << 7  ///< ground is valid
+	};
+
+	rule_area_t(koord pos_) : pos(pos_)
+	{
+		memset( known, 0, sizeof(known) );
+	}
+
+	koord get_pos() const { return pos; }
+
+	/// @returns ground of the square x,y of the area (pos is 3,3) or NULL if outside of the map
+	const grund_t *get_ground(uint8 x, uint8 y)
+	{
+		if(  (known[y][x] & looked_up) == 0  ) {
+			ground[y][x] = welt->lookup_kartenboden( pos.x+x-3, pos.y+y-3 );
+			known[y][x] = looked_up;
+			value[y][x] = 0;
+		}
+		return ground[y][x];
+	}
+
+	/// @returns whether the square x,y has the property @p what, get_ground() must not be NULL
+	bool is(uint8 x, uint8 y, uint8 what)
+	{
+		if(  (known[y][x] & what) == 0  ) {
+			const grund_t *gr = ground[y][x];
+			bool v = false;
+			switch(  what  ) {
+				case road:      v = gr->hat_weg(road_wt); break;
+				case fundament: v = gr->get_typ() == grund_t::fundament; break;
+				case house:     v = gr->get_typ() == grund_t::fundament  &&  gr->obj_bei(0)->get_typ() == obj_t::gebaeude; break;
+				case stop:      v = gr->is_halt(); break;
+				case removable: v = gr->kann_alle_obj_entfernen(NULL) == NULL; break;
+				case way_slope: v = slope_t::is_way_double(gr->get_grund_hang(), stadt_t::city_road->has_double_slopes()); break;
+			}
+			known[y][x] |= what;
+			if(  v  ) {
+				value[y][x] |= what;
+			}
+		}
+		return (value[y][x] & what) != 0;
+	}
+
+private:
+	static karte_ptr_t welt;
+
+	koord pos;
+	const grund_t *ground[7][7];
+	uint8 known[7][7];
+	uint8 value[7][7];
+};
+
+karte_ptr_t rule_area_t::welt;
+
+
+/**
+ * @param area squares around the position to check
  * @param regel the rule to evaluate
  * @return true on match, false otherwise
  */
-bool stadt_t::bewerte_loc(const koord pos, const rule_t &regel, int rotation)
+bool stadt_t::bewerte_loc(rule_area_t &area, const rule_t &regel, int rotation)
 {
-	//printf("Test for (%s) in rotation %d\n", pos.get_str(), rotation);
-	koord k;
-
 	for(rule_entry_t const& r : regel.rule) {
 		uint8 x,y;
 		switch (rotation) {
@@ -197,49 +264,47 @@ bool stadt_t::bewerte_loc(const koord pos, const rule_t &regel, int rotation)
 			case 270: x=6-r.y; y=r.x; break;
 		}
 
-		const koord k(pos.x+x-3, pos.y+y-3);
-		const grund_t* gr = welt->lookup_kartenboden(k);
-		if (gr == NULL) {
+		if (area.get_ground(x, y) == NULL) {
 			// outside of the map => cannot apply this rule
 			return false;
 		}
 		switch (r.flag) {
 			case 's':
 				// road?
-				if (!gr->hat_weg(road_wt)) return false;
+				if (!area.is(x, y, rule_area_t::road)) return false;
 				break;
 			case 'S':
 				// not road?
-				if (gr->hat_weg(road_wt)) return false;
+				if (area.is(x, y, rule_area_t::road)) return false;
 				break;
 			case 'h':
 				// is house
-				if (gr->get_typ() != grund_t::fundament  ||  gr->obj_bei(0)->get_typ()!=obj_t::gebaeude) return false;
+				if (!area.is(x, y, rule_area_t::house)) return false;
 				break;
 			case 'H':
 				// no house
-				if (gr->get_typ() == grund_t::fundament) return false;
+				if (area.is(x, y, rule_area_t::fundament)) return false;
 				break;
 			case 'n':
 				// nature/empty
-				if (!gr->ist_natur()) return false;
-				if (!gr->kann_alle_obj_entfernen(NULL)) return false;
+				if (!area.get_ground(x, y)->ist_natur()) return false;
+				if (area.is(x, y, rule_area_t::removable)) return false;
 				break;
 			case 'U':
 				// unbuildable for road
-				if (!slope_t::is_way_double(gr->get_grund_hang(), city_road->has_double_slopes())) return false;
+				if (!area.is(x, y, rule_area_t::way_slope)) return false;
 				break;
 			case 'u':
 				// road may be buildable
-				if (slope_t::is_way_double(gr->get_grund_hang(), city_road->has_double_slopes())) return false;
+				if (area.is(x, y, rule_area_t::way_slope)) return false;
 				break;
 			case 't':
 				// here is a stop/extension building
-				if (!gr->is_halt()) return false;
+				if (!area.is(x, y, rule_area_t::stop)) return false;
 				break;
 			case 'T':
 				// no stop
-				if (gr->is_halt()) return false;
+				if (area.is(x, y, rule_area_t::stop)) return false;
 				break;
 			default: ;
 				// ignore
@@ -253,37 +318,36 @@ bool stadt_t::bewerte_loc(const koord pos, const rule_t &regel, int rotation)
  * Check rule in all transformations at given position
  * @note but the rules should explicitly forbid building then?!?
  */
-sint32 stadt_t::bewerte_pos(const koord pos, const rule_t &regel)
+sint32 stadt_t::bewerte_pos(rule_area_t &area, const rule_t &regel)
 {
-	const grund_t* gr = welt->lookup_kartenboden(pos);
-	if (!gr  ||  gr->kann_alle_obj_entfernen(NULL)) {
+	if (!area.get_ground(3, 3)  ||  !area.is(3, 3, rule_area_t::removable)) {
 		// cannot built on empty tiles or tiles with an other owner's object
 		return 0;
 	}
 
 	// will be called only a single time, so we can stop after a single match
-	if(bewerte_loc(pos, regel,   0) ||
-		 bewerte_loc(pos, regel,  90) ||
-		 bewerte_loc(pos, regel, 180) ||
-		 bewerte_loc(pos, regel, 270)) {
+	if(bewerte_loc(area, regel,   0) ||
+		 bewerte_loc(area, regel,  90) ||
+		 bewerte_loc(area, regel, 180) ||
+		 bewerte_loc(area, regel, 270)) {
 		return 1;
 	}
 	return 0;
 }
 
 
-void stadt_t::bewerte_strasse(koord k, sint32 rd, const rule_t &regel)
+void stadt_t::bewerte_strasse(rule_area_t &area, sint32 rd, const rule_t &regel)
 {
 	if (simrand(rd) == 0) {
-		best_strasse.check(k, bewerte_pos(k, regel));
+		best_strasse.check(area.get_pos(), bewerte_pos(area, regel));
 	}
 }
 
 
-void stadt_t::bewerte_haus(koord k, sint32 rd, const rule_t &regel)
+void stadt_t::bewerte_haus(rule_area_t &area, sint32 rd, const rule_t &regel)
 {
 	if (simrand(rd) == 0) {
-		best_haus.check(k, bewerte_pos(k, regel));
+		best_haus.check(area.get_pos(), bewerte_pos(area, regel));
 	}
 }
 
@@ -4115,13 +4179,16 @@ void stadt_t::build()
 
 	// ATTENTION: the building position IS NOT this position; the is merely where the rule search starts
 
+	// the squares around k, shared by all rules as nothing is built until one matches
+	rule_area_t area(k);
+
 	// since only a single location is checked, we can stop after we have found a positive rule
 	best_strasse.reset(k);
 	const uint32 num_road_rules = road_rules.get_count();
 	uint32 offset = simrand(num_road_rules); // start with random rule
 	for (uint32 i = 0; i < num_road_rules  &&  !best_strasse.found(); i++) {
 		uint32 rule = ( i+offset ) % num_road_rules;
-		bewerte_strasse(k, 8 + road_rules[rule]->chance, *road_rules[rule]);
+		bewerte_strasse(area, 8 + road_rules[rule]->chance, *road_rules[rule]);
 	}
 	// ok => then built road
 	if (best_strasse.found()) {
@@ -4136,7 +4203,7 @@ void stadt_t::build()
 	offset = simrand(num_house_rules); // start with random rule
 	for(  uint32 i = 0;  i < num_house_rules  &&  !best_haus.found();  i++  ) {
 		uint32 rule = ( i+offset ) % num_house_rules;
-		bewerte_haus(k, 8 + house_rules[rule]->chance, *house_rules[rule]);
+		bewerte_haus(area, 8 + house_rules[rule]->chance, *house_rules[rule]);
 	}
 	// one rule applied?
 	if(  best_haus.found()  ) {
@@ -20,6 +20,7 @@
 class building_desc_t;
 class karte_ptr_t;
 class player_t;
+class rule_area_t;
 class rule_t;
 class way_desc_t;
 
@@ -426,20 +427,20 @@ private:
 	void build();
 
 	/**
-	 * @param pos position to check
+	 * @param area squares around the position to check
 	 * @param regel the rule to evaluate
 	 * @param rotation
 	 * @return true on match, false otherwise
 	 */
-	static bool bewerte_loc(koord pos, const rule_t &regel, int rotation);
+	static bool bewerte_loc(rule_area_t &area, const rule_t &regel, int rotation);
 
 	/**
 	 * Check rule in all transformations at given position
 	 */
-	static sint32 bewerte_pos(koord pos, const rule_t &regel);
+	static sint32 bewerte_pos(rule_area_t &area, const rule_t &regel);
 
-	void bewerte_strasse(koord pos, sint32 rd, const rule_t &regel);
-	void bewerte_haus(koord pos, sint32 rd, const rule_t &regel);
+	void bewerte_strasse(rule_area_t &area, sint32 rd, const rule_t &regel);
+	void bewerte_haus(rule_area_t &area, sint32 rd, const rule_t &regel);
 
 public:
 	bool is_within_players_network( const player_t* player ) const;
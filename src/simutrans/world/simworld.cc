@@ -304,37 +304,78 @@ void karte_t::recalc_season_snowline(bool set_pending)
 
 void karte_t::perlin_hoehe_loop( sint16 x_min, sint16 x_max, sint16 y_min, sint16 y_max )
 {
+	sint16 *hgt = new sint16[x_max - x_min];
 	for(  int y = y_min;  y < y_max;  y++  ) {
+		// whole rows at once
+		perlin_hoehe_line( &settings, koord(x_min, y), koord(1, 0), koord(0, 0), x_max - x_min, hgt );
 		for(  int x = x_min; x < x_max;  x++  ) {
-			// loop all tiles
-			koord k(x,y);
-			sint16 const h = perlin_hoehe(&settings, k, koord(0, 0));
-			set_grid_hgt_nocheck( k, (sint8) h);
+			set_grid_hgt_nocheck( koord(x,y), (sint8)hgt[x - x_min] );
 		}
 	}
+	delete [] hgt;
 }
 
 
-sint32 karte_t::perlin_hoehe(settings_t const* const sets, koord k, koord const size)
+// position of grid point k in the noise
+static koord perlin_position(settings_t const* const sets, koord k, koord const size)
 {
-	// replace the fixed values with your settings. Amplitude is the top highness of the mountains,
-	// frequency is something like landscape 'roughness'; amplitude may not be greater than 160.0 !!!
-	// please don't allow frequencies higher than 0.8, it'll break the AI's pathfinding.
-	// Frequency values of 0.5 .. 0.7 seem to be ok, less is boring flat, more is too crumbled
-	// the old defaults are given here: f=0.6, a=160.0
 	switch( sets->get_rotation() ) {
 		// 0: do nothing
 		case 1: k = koord(k.y,size.x-k.x); break;
 		case 2: k = koord(size.x-k.x,size.y-k.y); break;
 		case 3: k = koord(size.y-k.y,k.x); break;
 	}
+	return k + koord(sets->get_origin_x(), sets->get_origin_y());
+}
+
+
+sint32 karte_t::perlin_hoehe(settings_t const* const sets, koord k, koord const size)
+{
+	// replace the fixed values with your settings. Amplitude is the top highness of the mountains,
+	// frequency is something like landscape 'roughness'; amplitude may not be greater than 160.0 !!!
+	// please don't allow frequencies higher than 0.8, it'll break the AI's pathfinding.
+	// Frequency values of 0.5 .. 0.7 seem to be ok, less is boring flat, more is too crumbled
+	// the old defaults are given here: f=0.6, a=160.0
 //    double perlin_noise_2D(double x, double y, double persistence);
 //    return ((int)(perlin_noise_2D(x, y, 0.6)*160.0)) & 0xFFFFFFF0;
-	k = k + koord(sets->get_origin_x(), sets->get_origin_y());
+	k = perlin_position( sets, k, size );
 	return ((int)(perlin_noise_2D(k.x, k.y, sets->get_map_roughness())*(double)sets->get_max_mountain_height())) / 16;
 }
 
 
+void karte_t::perlin_hoehe_line(settings_t const* const sets, koord k, koord const step, koord const size, uint32 count, sint16 *result)
+{
+	if(  count == 0  ) {
+		return;
+	}
+
+	// the rotation is linear, so the points are equally spaced in the noise too
+	const koord start = perlin_position( sets, k, size );
+	const koord noise_step = perlin_position( sets, k + step, size ) - start;
+	const sint32 end_x = start.x + (sint32)(count - 1) * noise_step.x;
+	const sint32 end_y = start.y + (sint32)(count - 1) * noise_step.y;
+	if(  end_x < -32768  ||  end_x > 32767  ||  end_y < -32768  ||  end_y > 32767  ) {
+		// koord would wrap around somewhere in between
+		for(  uint32 n = 0;  n < count;  n++  ) {
+			result[n] = perlin_hoehe( sets, k, size );
+			k += step;
+		}
+		return;
+	}
+
+	double noise[256];
+	const double max_mountain_height = sets->get_max_mountain_height();
+	for(  uint32 done = 0;  done < count;  ) {
+		const uint32 n_max = min( count - done, (uint32)lengthof(noise) );
+		perlin_noise_2D_line( start.x + (sint32)done * noise_step.x, start.y + (sint32)done * noise_step.y, noise_step.x, noise_step.y, n_max, sets->get_map_roughness(), noise );
+		for(  uint32 n = 0;  n < n_max;  n++  ) {
+			result[done + n] = ((int)(noise[n] * max_mountain_height)) / 16;
+		}
+		done += n_max;
+	}
+}
+
+
 void karte_t::cleanup_grounds_loop( sint16 x_min, sint16 x_max, sint16 y_min, sint16 y_max )
 {
 	for(  int y = y_min;  y < y_max;  y++  ) {
@@ -1746,6 +1787,9 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 	clear_random_mode( 0xFFFF );
 	set_random_mode( MAP_CREATE_RANDOM );
 
+	// times of the phases for the log
+	const uint32 ms_start = dr_time();
+
 	if(  new_world  &&  !settings.heightfield.empty()  ) {
 		// init from file
 		for(int y=0; y<cached_grid_size.y; y++) {
@@ -1765,14 +1809,18 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 		}
 		if (  old_size.x > 0  &&  old_size.y > 0  ) {
 			// loop only new tiles:
+			sint16 *hgt = new sint16[new_size.x + 1];
 			for(  sint16 y = 0;  y<=new_size.y;  y++  ) {
-				for(  sint16 x = (y>old_size.y) ? 0 : old_size.x+1;  x<=new_size.x;  x++  ) {
-					koord k(x,y);
-					sint16 const h = perlin_hoehe(&settings, k, koord(old_size.x, old_size.y));
-					set_grid_hgt_nocheck( k, (sint8) h);
+				const sint16 x_min = (y>old_size.y) ? 0 : old_size.x+1;
+				if(  x_min <= new_size.x  ) {
+					perlin_hoehe_line( &settings, koord(x_min, y), koord(1, 0), koord(old_size.x, old_size.y), new_size.x + 1 - x_min, hgt );
+				}
+				for(  sint16 x = x_min;  x<=new_size.x;  x++  ) {
+					set_grid_hgt_nocheck( koord(x,y), (sint8)hgt[x - x_min] );
 				}
 				ls.set_progress( (y*16)/new_size.y );
 			}
+			delete [] hgt;
 		}
 		else {
 			world_xy_loop(&karte_t::perlin_hoehe_loop, GRIDS_FLAG);
@@ -1821,6 +1869,8 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 		}
 	}
 
+	const uint32 ms_heights = dr_time();
+
 	// smooth the new part, reassign slopes on new part
 	cleanup_karte( old_size.x, old_size.y );
 	if (  new_world  ) {
@@ -1844,6 +1894,8 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 		ls.set_progress(12);
 	}
 
+	const uint32 ms_grounds = dr_time();
+
 	DBG_DEBUG("karte_t::distribute_groundobjs_cities()","distributing rivers");
 	if(  sets->get_lakeheight() > 0  ) {
 		create_lakes( old_size.x, old_size.y, sets->get_lakeheight() );
@@ -1853,6 +1905,7 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 	if(  env_t::river_types > 0  &&  settings.get_river_number() > 0  ) {
 		create_rivers( settings.get_river_number() );
 	}
+	const uint32 ms_water = dr_time();
 
 	if (  new_world  ) {
 		ls.set_progress(13);
@@ -1903,7 +1956,10 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 		}
 	}
 
+	const uint32 ms_climates = dr_time();
+
 	distribute_cities( sets->get_city_count(), sets->get_mean_citizen_count(), old_size.x, old_size.y );
+	const uint32 ms_cities = dr_time();
 
 	if( new_world ) {
 		distribute_trees_region( 0, 0, new_size.x, new_size.y );
@@ -1914,6 +1970,9 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 	}
 	humidity_map.clear();
 
+	dbg->message( "karte_t::enlarge_map()", "%ix%i: heights %u ms, grounds %u ms, lakes and rivers %u ms, climates %u ms, cities %u ms, trees %u ms",
+		new_size.x, new_size.y, ms_heights - ms_start, ms_grounds - ms_heights, ms_water - ms_grounds, ms_climates - ms_water, ms_cities - ms_climates, dr_time() - ms_cities );
+
 	// eventual update origin
 	switch(  settings.get_rotation()  ) {
 		case 1: {
@@ -2219,6 +2278,15 @@ void karte_t::set_tool_api( tool_t *tool_in, player_t *player, bool& suspended)
 		return;
 	}
 	tool_in->flags |= (event_get_last_control_shift() ^ tool_t::control_invert);
+	if(  ai_scripted_t::is_stepping_parallel()  ) {
+		// scripted ais plan in parallel and must not change the world: send it afterwards
+		assert( player  &&  player->get_ai_id() == player_t::AI_SCRIPTED );
+		const bool to_server = env_t::networkmode  &&  !tool_in->is_local_execution()  &&  !tool_in->is_init_keeps_game_state();
+		nwc_tool_t *nwc = new nwc_tool_t(player, tool_in, zeiger->get_pos(), to_server ? steps : 0, map_counter, true);
+		static_cast<ai_scripted_t *>(player)->defer_command( nwc, to_server );
+		suspended = true;
+		return;
+	}
 	if(!env_t::networkmode  ||  tool_in->is_local_execution()  ||  tool_in->is_init_keeps_game_state()  ) {
 
 		if (tool_in->is_init_keeps_game_state()  ||  (get_random_mode() & INTERACTIVE_RANDOM) == 0) {
@@ -3293,12 +3361,19 @@ void karte_t::step()
 //	senke_t::step_all(delta_t); // not needed, handeld by sunc_step already
 
 	DBG_DEBUG4("karte_t::step", "step players");
-	// then step all players
+	// then step all players, in parallel mode the scripted ones last
+	vector_tpl<ai_scripted_t *> scripted_ais;
 	for(  int i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
 		if(  players[i] != NULL  ) {
-			players[i]->step();
+			if(  env_t::parallel_ai_scripts  &&  players[i]->get_ai_id() == player_t::AI_SCRIPTED  ) {
+				scripted_ais.append( static_cast<ai_scripted_t *>(players[i]) );
+			}
+			else {
+				players[i]->step();
+			}
 		}
 	}
+	ai_scripted_t::step_all( scripted_ais );
 
 	DBG_DEBUG4("karte_t::step", "step halts");
 	haltestelle_t::step_all();
@@ -5818,7 +5893,16 @@ const char* karte_t::call_work_api(tool_t *tool, player_t *player, koord3d pos,
 		}
 	}
 	if (err == NULL) {
-		if(  !env_t::networkmode  ||  network_safe_tool  ) {
+		if(  ai_scripted_t::is_stepping_parallel()  &&  !network_safe_tool  ) {
+			// scripted ais plan in parallel and must not change the world: send it afterwards
+			assert( player  &&  player->get_ai_id() == player_t::AI_SCRIPTED );
+			nwc_tool_t *nwc = new nwc_tool_t(player, tool, pos, get_steps(), get_map_counter(), false);
+			static_cast<ai_scripted_t *>(player)->defer_command( nwc, env_t::networkmode );
+			// reset tool
+			tool->init(player);
+			suspended = true;
+		}
+		else if(  !env_t::networkmode  ||  network_safe_tool  ) {
 			if(  network_safe_tool  ||  (get_random_mode() & INTERACTIVE_RANDOM) == 0  ) {
 				// call work if it would not affect game state or if the call is not during sync_step
 				err = tool->work(player, pos);
@@ -85,6 +85,12 @@ public:
 	 */
 	static sint32 perlin_hoehe(settings_t const *sets, koord k, koord size);
 
+	/**
+	 * Same as perlin_hoehe() for @p count points, starting at @p k and going @p step further each.
+	 * Much faster than calling perlin_hoehe() for each point.
+	 */
+	static void perlin_hoehe_line(settings_t const *sets, koord k, koord step, koord size, uint32 count, sint16 *result);
+
 	/**
 	 * Loops over tiles setting heights from perlin noise
 	 */
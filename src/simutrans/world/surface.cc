@@ -97,21 +97,25 @@ bool surface_t::square_is_free(koord pos, sint16 w, sint16 h, int *last_y, clima
 			// we can built, if: max height all the same, everything removable and no buildings there
 			slope_t::type slope = gr->get_grund_hang();
 			sint8 max_height = gr->get_hoehe() + slope_t::max_diff(slope);
-			climate test_climate = get_climate(k_check);
-			if(  cl & (1 << water_climate)  &&  test_climate != water_climate  ) {
+			bool ok = !(  (platz_max_h != max_height  &&  platz_base_h != gr->get_hoehe())  ||  !gr->ist_natur()  ||  gr->kann_alle_obj_entfernen(NULL) != NULL  ||
+			     ( slope && (lookup( gr->get_pos()+koord3d(0,0,1) ) ||
+			     (slope_t::max_diff(slope)==2 && lookup( gr->get_pos()+koord3d(0,0,2) )) ))  );
+
+			// the neighbours only matter if the climate itself is not allowed: land next to water counts as water
+			const climate test_climate = get_climate(k_check);
+			if(  ok  &&  (cl & (1 << test_climate)) == 0  ) {
 				bool neighbour_water = false;
-				for(int i=0; i<8  &&  !neighbour_water; i++) {
-					if(  is_within_limits(k_check + koord::neighbours[i])  &&  get_climate( k_check + koord::neighbours[i] ) == water_climate  ) {
-						neighbour_water = true;
+				if(  cl & (1 << water_climate)  &&  test_climate != water_climate  ) {
+					for(int i=0; i<8  &&  !neighbour_water; i++) {
+						if(  is_within_limits(k_check + koord::neighbours[i])  &&  get_climate( k_check + koord::neighbours[i] ) == water_climate  ) {
+							neighbour_water = true;
+						}
 					}
 				}
-				if(  neighbour_water  ) {
-					test_climate = water_climate;
-				}
+				ok = neighbour_water;
 			}
-			if( (platz_max_h != max_height  &&  platz_base_h != gr->get_hoehe())  ||  !gr->ist_natur()  ||  gr->kann_alle_obj_entfernen(NULL) != NULL  ||
-			     (cl & (1 << test_climate)) == 0  ||  ( slope && (lookup( gr->get_pos()+koord3d(0,0,1) ) ||
-			     (slope_t::max_diff(slope)==2 && lookup( gr->get_pos()+koord3d(0,0,2) )) ))  ) {
+
+			if(  !ok  ) {
 				if(  last_y  ) {
 					*last_y = k_check.y;
 				}
@@ -2,8 +2,16 @@
 
 #include "squirrel/sqpcheader.h" // for declarations...
 #include "squirrel/sqvm.h"       // for Raise_Error_vl
+#include "squirrel/sqfuncproto.h"
+#include "squirrel/sqclosure.h"
+#include "squirrel/sqstring.h"
 #include <stdarg.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
 #include "../simutrans/tpl/ptrhashtable_tpl.h"
+#include "../simutrans/tpl/vector_tpl.h"
+#include "../simutrans/utils/cbuffer.h"
 
 // store data associate to vm's here
 struct my_vm_info_t {
@@ -118,3 +126,263 @@ const char* sq_get_suspend_blocker(HSQUIRRELVM v)
 {
 	return vm_info.get(v).suspend_blocker;
 }
+
+
+/// node of the call tree, nodes[0] is the root
+struct sq_profile_node_t {
+	const void *key;     ///< function prototype of scripted functions, closure of native functions
+	std::string name;
+	uint32 parent, first_child, next_sibling;
+	uint64 ops;          ///< opcodes executed in this function (not in called functions)
+	uint64 time;         ///< microseconds spent in this function
+	uint32 calls;
+};
+
+/// node of an entry of the call stack, to avoid searching the call tree on every call
+struct sq_profile_frame_t {
+	const void *key; ///< key of the node, a closure may be freed and another one get its address
+	uint32 node;
+};
+
+struct sq_profile_t {
+	vector_tpl<sq_profile_node_t> nodes;
+	vector_tpl<sq_profile_frame_t> frames;
+	SQInteger last_ops;
+	uint64 last_time;
+	bool paused;
+};
+
+#define PROFILE_NONE (0xFFFFFFFFu)
+
+
+static uint64 profile_time()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+void sq_profile_start(HSQUIRRELVM v)
+{
+	delete v->_profile;
+	v->_profile = new sq_profile_t();
+
+	sq_profile_node_t root;
+	root.key = NULL;
+	root.parent = root.first_child = root.next_sibling = PROFILE_NONE;
+	root.ops = root.time = 0;
+	root.calls = 0;
+	v->_profile->nodes.append(root);
+
+	v->_profile->last_ops = v->_ops_total;
+	v->_profile->last_time = profile_time();
+	v->_profile->paused = false;
+}
+
+
+void sq_profile_stop(HSQUIRRELVM v)
+{
+	delete v->_profile;
+	v->_profile = NULL;
+}
+
+
+bool sq_profile_active(HSQUIRRELVM v)
+{
+	return v->_profile != NULL;
+}
+
+
+static const char *profile_string(const SQObjectPtr &o, const char *fallback)
+{
+	return sq_type(o) == OT_STRING ? _stringval(o) : fallback;
+}
+
+
+/// @returns what identifies the function of closure @p c in the call tree
+static const void *profile_key(const SQObjectPtr &c)
+{
+	switch(sq_type(c)) {
+		case OT_CLOSURE:       return _closure(c)->_function;
+		case OT_NATIVECLOSURE: return _nativeclosure(c);
+		default:               return NULL;
+	}
+}
+
+
+/// @returns child of @p parent for closure @p c, creates it if needed
+static uint32 profile_find_child(sq_profile_t *p, uint32 parent, const SQObjectPtr &c)
+{
+	const void *key = profile_key(c);
+
+	for(uint32 i = p->nodes[parent].first_child;  i != PROFILE_NONE;  i = p->nodes[i].next_sibling) {
+		if(p->nodes[i].key == key) {
+			return i;
+		}
+	}
+
+	sq_profile_node_t node;
+	node.key = key;
+	if(sq_type(c) == OT_CLOSURE) {
+		const SQFunctionProto *func = _closure(c)->_function;
+		// only file name of the source, flamegraph lines get long enough
+		const char *src = profile_string(func->_sourcename, "?");
+		for(const char *s = src; *s; s++) {
+			if(*s == '/'  ||  *s == '\\') {
+				src = s + 1;
+			}
+		}
+		cbuffer_t buf;
+		buf.printf("%s %s:%d", profile_string(func->_name, "unknown"), src, func->_nlineinfos > 0 ? (int)func->_lineinfos[0]._line : 0);
+		node.name = (const char*)buf;
+	}
+	else if(sq_type(c) == OT_NATIVECLOSURE) {
+		node.name = std::string(profile_string(_nativeclosure(c)->_name, "unknown")) + " (native)";
+	}
+	else {
+		node.name = "unknown";
+	}
+	// ';' separates the frames in the report
+	std::replace(node.name.begin(), node.name.end(), ';', ',');
+
+	node.parent = parent;
+	node.first_child = PROFILE_NONE;
+	node.next_sibling = p->nodes[parent].first_child;
+	node.ops = node.time = 0;
+	node.calls = 0;
+	p->nodes.append(node);
+	p->nodes[parent].first_child = p->nodes.get_count() - 1;
+	return p->nodes.get_count() - 1;
+}
+
+
+void sq_profile_charge(HSQUIRRELVM v, bool leave)
+{
+	sq_profile_t *p = v->_profile;
+	const uint64 now = profile_time();
+	if(p->paused) {
+		// the vm was suspended and called again without resume: nothing to charge
+		p->paused = false;
+		p->last_time = now;
+		p->last_ops = v->_ops_total;
+		return;
+	}
+
+	// find node of the current call stack, reuse the nodes of the unchanged frames
+	const uint32 depth = v->_callsstacksize;
+	uint32 node = 0;
+	bool valid = true;
+	for(uint32 i = 0; i < depth; i++) {
+		const SQObjectPtr &c = v->_callsstack[i]._closure;
+		const void *key = profile_key(c);
+		if(valid  &&  i < p->frames.get_count()  &&  p->frames[i].key == key) {
+			node = p->frames[i].node;
+			continue;
+		}
+		valid = false;
+		node = profile_find_child(p, node, c);
+		sq_profile_frame_t frame = { key, node };
+		if(i < p->frames.get_count()) {
+			p->frames[i] = frame;
+		}
+		else {
+			p->frames.append(frame);
+		}
+	}
+
+	sq_profile_node_t &n = p->nodes[node];
+	n.ops += v->_ops_total - p->last_ops;
+	n.time += now - p->last_time;
+	if(leave) {
+		n.calls++;
+	}
+	p->last_ops = v->_ops_total;
+	p->last_time = now;
+}
+
+
+void sq_profile_pause(HSQUIRRELVM v)
+{
+	sq_profile_charge(v, false);
+	v->_profile->paused = true;
+}
+
+
+void sq_profile_resume(HSQUIRRELVM v)
+{
+	sq_profile_t *p = v->_profile;
+	p->paused = false;
+	p->last_ops = v->_ops_total;
+	p->last_time = profile_time();
+}
+
+
+static void profile_write_node(const sq_profile_t *p, uint32 index, std::string &path, FILE *f, bool wall_time)
+{
+	const sq_profile_node_t &n = p->nodes[index];
+	const size_t len = path.size();
+	if(index != 0) {
+		path += ';';
+		path += n.name;
+		const uint64 value = wall_time ? n.time : n.ops;
+		if(value > 0) {
+			fprintf(f, "%s %llu\n", path.c_str(), (unsigned long long)value);
+		}
+	}
+	for(uint32 i = n.first_child;  i != PROFILE_NONE;  i = p->nodes[i].next_sibling) {
+		profile_write_node(p, i, path, f, wall_time);
+	}
+	path.resize(len);
+}
+
+
+void sq_profile_write(HSQUIRRELVM v, FILE *f, const char *root, bool wall_time)
+{
+	if(v->_profile) {
+		std::string path(root);
+		profile_write_node(v->_profile, 0, path, f, wall_time);
+	}
+}
+
+
+struct sq_profile_sum_t {
+	const char *name;
+	uint64 ops, time;
+	uint32 calls;
+};
+
+static bool compare_profile_sum(const sq_profile_sum_t &a, const sq_profile_sum_t &b)
+{
+	return a.time > b.time;
+}
+
+
+void sq_profile_summary(HSQUIRRELVM v, cbuffer_t &buf, SQInteger max_lines)
+{
+	const sq_profile_t *p = v->_profile;
+	if(p == NULL) {
+		return;
+	}
+
+	// same function in different call stacks
+	ptrhashtable_tpl<const void*, uint32> index;
+	vector_tpl<sq_profile_sum_t> sums;
+	for(uint32 i = 1; i < p->nodes.get_count(); i++) {
+		const sq_profile_node_t &n = p->nodes[i];
+		const uint32 *i_sum = index.access(n.key);
+		if(i_sum == NULL) {
+			index.put(n.key, sums.get_count());
+			sq_profile_sum_t sum = { n.name.c_str(), 0, 0, 0 };
+			sums.append(sum);
+			i_sum = index.access(n.key);
+		}
+		sq_profile_sum_t &sum = sums[*i_sum];
+		sum.ops += n.ops;
+		sum.time += n.time;
+		sum.calls += n.calls;
+	}
+	std::sort(sums.begin(), sums.end(), compare_profile_sum);
+
+	for(uint32 i = 0; i < sums.get_count()  &&  (SQInteger)i < max_lines; i++) {
+		buf.printf("%9.3f ms %10llu ops %8u calls  %s\n", sums[i].time / 1000.0, (unsigned long long)sums[i].ops, sums[i].calls, sums[i].name);
+	}
+}
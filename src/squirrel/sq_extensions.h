@@ -3,6 +3,10 @@
 
 #include "squirrel.h"
 
+#include <stdio.h>
+
+class cbuffer_t;
+
 /**
  * Extensions to the squirrel engine
  * for simutrans
@@ -71,4 +75,42 @@ SQRESULT sq_get_ops_total(HSQUIRRELVM v);
 /// @returns amount of remaining opcodes until vm will be suspended
 SQRESULT sq_get_ops_remaing(HSQUIRRELVM v);
 
+/**
+ * @name Profiling of script functions
+ * Records opcodes and time spent in each function, separated by call stacks.
+ * The time includes native functions called by the script.
+ * @{
+ */
+
+/// Starts recording for vm @p v, forgets previous records.
+void sq_profile_start(HSQUIRRELVM v);
+
+/// Stops recording and forgets the records.
+void sq_profile_stop(HSQUIRRELVM v);
+
+/// @returns whether @p v is recording
+bool sq_profile_active(HSQUIRRELVM v);
+
+/**
+ * Writes records in the folded stack format of flamegraph.pl:
+ * one line "root;function;called function value" per call stack.
+ * @param root name of the outermost frame
+ * @param wall_time if true values are microseconds, otherwise opcodes
+ */
+void sq_profile_write(HSQUIRRELVM v, FILE *f, const char *root, bool wall_time);
+
+/// Prints the @p max_lines functions with most time spent in them (over all call stacks).
+void sq_profile_summary(HSQUIRRELVM v, cbuffer_t &buf, SQInteger max_lines);
+
+/// Called by vm when a call frame is entered (@p leave false) or left.
+void sq_profile_charge(HSQUIRRELVM v, bool leave);
+
+/// Called by vm when suspended, time till resume is not counted.
+void sq_profile_pause(HSQUIRRELVM v);
+
+/// Called by vm when resumed.
+void sq_profile_resume(HSQUIRRELVM v);
+
+/// @}
+
 #endif
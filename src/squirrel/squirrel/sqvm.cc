@@ -13,6 +13,7 @@
 #include "squserdata.h"
 #include "sqarray.h"
 #include "sqclass.h"
+#include "../sq_extensions.h"
 
 #define TOP() (_stack._vals[_top-1])
 #define TARGET _stack._vals[_stackbase+arg0]
@@ -130,6 +131,7 @@ SQVM::SQVM(SQSharedState *ss)
 	_ops_total = 0;
 	_ops_grace_amount = 500;
 	_throw_if_no_ops = true;
+	_profile = NULL;
 }
 
 void SQVM::Finalize()
@@ -142,6 +144,7 @@ void SQVM::Finalize()
 	_debughook = false;
 	_debughook_native = NULL;
 	_debughook_closure.Null();
+	if(_profile) sq_profile_stop(this);
 	temp_reg.Null();
 	_callstackdata.resize(0);
 	SQInteger size=_stack.size();
@@ -712,6 +715,7 @@ bool SQVM::Execute(SQObjectPtr &closure, SQInteger nargs, SQInteger stackbase,SQ
 		case ET_RESUME_THROW_VM:
 			traps = _suspended_traps;
 			ci->_root = _suspended_root;
+			if (_profile) sq_profile_resume(this);
 			_suspended = SQFalse;
 			if(et  == ET_RESUME_THROW_VM) { SQ_THROW(); }
 			break;
@@ -727,6 +731,7 @@ exception_restore:
 			if (_ops_remaining < 0) {
 				// suspend vm
 				if (can_suspend  &&  !_throw_if_no_ops) {
+					if (_profile) sq_profile_pause(this);
 					_suspended = SQTrue;
 					_suspended_root = ci->_root;
 					_suspended_traps = traps;
@@ -787,6 +792,7 @@ exception_restore:
 						bool tailcall;
 						_GUARD(CallNative(_nativeclosure(clo), arg3, _stackbase+arg2, clo, (SQInt32)sarg0, suspend, tailcall));
 						if(suspend){
+							if (_profile) sq_profile_pause(this);
 							_suspended = SQTrue;
 							_suspended_target = sarg0;
 							_suspended_root = ci->_root;
@@ -1685,6 +1691,7 @@ void SQVM::FindOuter(SQObjectPtr &target, SQObjectPtr *stackindex)
 
 bool SQVM::EnterFrame(SQInteger newbase, SQInteger newtop, bool tailcall)
 {
+	if (_profile) sq_profile_charge(this, false);
 	if( !tailcall ) {
 		if( _callsstacksize == _alloccallsstacksize ) {
 			GrowCallStack();
@@ -1715,6 +1722,7 @@ bool SQVM::EnterFrame(SQInteger newbase, SQInteger newtop, bool tailcall)
 }
 
 void SQVM::LeaveFrame() {
+	if (_profile) sq_profile_charge(this, true);
 	SQInteger last_top = _top;
 	SQInteger last_stackbase = _stackbase;
 	SQInteger css = --_callsstacksize;
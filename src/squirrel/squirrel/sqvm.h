@@ -30,6 +30,8 @@ struct SQExceptionTrap{
 
 typedef sqvector<SQExceptionTrap> ExceptionsTraps;
 
+struct sq_profile_t; // sq_extensions
+
 struct SQVM : public CHAINABLE_OBJ
 {
 	struct CallInfo{
@@ -183,6 +185,7 @@ public:
 	SQInteger _ops_grace_amount; /// raise error if _ops_remaining is less than  -_ops_grace_amount for pure native calls
 	SQInteger _ops_total;        /// total number of ops performed
 	bool _throw_if_no_ops;       /// is no-ops an error or can call suspended? default: true
+	sq_profile_t *_profile;      /// ops and time per call stack, NULL if not profiling (see sq_profile_start)
 };
 
 struct AutoDec{